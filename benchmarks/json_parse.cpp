@@ -0,0 +1,119 @@
+// Parse + destroy benchmark for Json::Value.
+//
+//   g++ -std=c++17 -O2 -Iinclude benchmarks/json_parse.cpp include/json/json_*.cpp
+//   ./a.out [file.json | file.ndjson ...]
+//
+// Without arguments it generates a language pack and an array of small
+// objects, the two shapes that dominate our documents. .ndjson files are
+// parsed one line at a time. Prints the best of several runs for each input.
+// Build again with -DJSONCPP_NO_SIMD to time the reader's scalar scanners.
+#include <json/json.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+const int kRuns = 5;
+
+Json::String readFile(const char* path) {
+  std::ifstream file(path, std::ios::binary);
+  std::ostringstream oss;
+  oss << file.rdbuf();
+  return oss.str();
+}
+
+Json::String generateLanguagePack(int entries) {
+  Json::String doc = "{\n";
+  for (int i = 0; i < entries; ++i) {
+    doc += "  \"page" + std::to_string(i % 97) + ".label" + std::to_string(i) +
+           "\": \"Label " + std::to_string(i) + "\"";
+    doc += i + 1 < entries ? ",\n" : "\n";
+  }
+  return doc + "}\n";
+}
+
+Json::String generateSmallObjects(int count) {
+  static const char* const kinds[] = {"info", "warn", "error", "debug"};
+  Json::String doc = "[";
+  for (int i = 0; i < count; ++i) {
+    if (i)
+      doc += ',';
+    doc += "{\"id\":" + std::to_string(i) + ",\"kind\":\"" + kinds[i % 4] +
+           "\",\"name\":\"item" + std::to_string(i) + "\",\"ok\":true}";
+  }
+  return doc + "]";
+}
+
+bool endsWith(const Json::String& str, const Json::String& suffix) {
+  return str.size() >= suffix.size() &&
+         str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Parses every non-empty line of \c doc as its own document.
+bool parseLines(Json::CharReader& reader, const Json::String& doc,
+                Json::String* errors) {
+  char const* p = doc.data();
+  char const* const end = p + doc.size();
+  while (p != end) {
+    char const* eol = std::find(p, end, '\n');
+    if (eol != p) {
+      Json::Value root;
+      if (!reader.parse(p, eol, &root, errors))
+        return false;
+    }
+    p = eol == end ? end : eol + 1;
+  }
+  return true;
+}
+
+// Best wall time in milliseconds of parsing \c doc and destroying the result.
+double bestParseAndDestroy(const Json::String& doc, bool lines) {
+  Json::CharReaderBuilder builder;
+  std::unique_ptr<Json::CharReader> const reader(builder.newCharReader());
+  double best = 1e300;
+  for (int run = 0; run < kRuns; ++run) {
+    auto const start = std::chrono::steady_clock::now();
+    {
+      Json::Value root;
+      Json::String errors;
+      if (lines ? !parseLines(*reader, doc, &errors)
+                : !reader->parse(doc.data(), doc.data() + doc.size(), &root,
+                                 &errors)) {
+        std::fprintf(stderr, "parse error: %s\n", errors.c_str());
+        return -1;
+      }
+    }
+    auto const elapsed = std::chrono::steady_clock::now() - start;
+    best = std::min(
+        best, std::chrono::duration<double, std::milli>(elapsed).count());
+  }
+  return best;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  std::vector<std::pair<Json::String, Json::String>> inputs;
+  for (int i = 1; i < argc; ++i)
+    inputs.emplace_back(argv[i], readFile(argv[i]));
+  if (inputs.empty()) {
+    inputs.emplace_back("language pack (150k entries)",
+                        generateLanguagePack(150000));
+    inputs.emplace_back("small objects (200k)", generateSmallObjects(200000));
+  }
+  for (const auto& input : inputs) {
+    double const ms = bestParseAndDestroy(input.second,
+                                          endsWith(input.first, ".ndjson"));
+    std::printf("%-32s %8.1f MB %10.2f ms\n", input.first.c_str(),
+                double(input.second.size()) / (1024 * 1024), ms);
+  }
+  return 0;
+}
@@ -1,4 +1,13 @@
 ﻿#include "chh.hpp"
+#include <algorithm>
+
+// 定义 CHH_NO_SIMD 可以关闭编码转换中的 SSE2 快速路径。
+#if !defined(CHH_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define CHH_USE_SSE2 1
+#include <emmintrin.h>
+#else
+#define CHH_USE_SSE2 0
+#endif
 
 namespace chh {
 
@@ -6,26 +15,269 @@ namespace chh {
 		return std::string(vec.begin(), vec.end());
 	}
 
+	// 解码 p 处的一个码点，成功时把 p 移到下一个码点。
+	// 截断、过长的编码、代理项和超出范围的码点都是无效的，返回 false，p 不变。
+	static bool decodeUtf8(const char*& p, const char* end, char32_t& code) {
+		const unsigned char c = *p;
+		if (c < 0x80) {
+			code = c;
+			p++;
+			return true;
+		}
+		int n;
+		if (c >= 0xC2 && c <= 0xDF) { code = c & 0x1F; n = 1; }
+		else if (c >= 0xE0 && c <= 0xEF) { code = c & 0x0F; n = 2; }
+		else if (c >= 0xF0 && c <= 0xF4) { code = c & 0x07; n = 3; }
+		else return false;
+		if (end - p <= n) return false;
+		for (int i = 1; i <= n; i++) {
+			const unsigned char next = p[i];
+			if ((next & 0xC0) != 0x80) return false;
+			code = (code << 6) | (next & 0x3F);
+		}
+		if ((n == 2 && code < 0x800) || (n == 3 && (code < 0x10000 || code > 0x10FFFF)) || (code >= 0xD800 && code <= 0xDFFF)) {
+			return false;
+		}
+		p += n + 1;
+		return true;
+	}
+
+	// 解码 UTF-8，写出 UTF-16 或 UTF-32 码元，返回写入的末尾。
+	// 输出至少要能容纳 end - p 个码元。Simd 为 false 时只走逐字节的路径，测试用它对照。
+	template <typename Char, bool Simd = bool(CHH_USE_SSE2)>
+	static Char* decodeUtf8(const char* p, const char* end, Char* out) {
+		while (p < end) {
+#if CHH_USE_SSE2
+			// 连续 16 个 ASCII 字节一次展开。
+			if (Simd && end - p >= 16) {
+				const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+				if (_mm_movemask_epi8(bytes) == 0) {
+					const __m128i zero = _mm_setzero_si128();
+					const __m128i lo = _mm_unpacklo_epi8(bytes, zero), hi = _mm_unpackhi_epi8(bytes, zero);
+					if constexpr (sizeof(Char) == 2) {
+						_mm_storeu_si128(reinterpret_cast<__m128i*>(out), lo);
+						_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), hi);
+					}
+					else {
+						_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi16(lo, zero));
+						_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_unpackhi_epi16(lo, zero));
+						_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpacklo_epi16(hi, zero));
+						_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 12), _mm_unpackhi_epi16(hi, zero));
+					}
+					p += 16;
+					out += 16;
+					continue;
+				}
+			}
+#endif
+			const unsigned char c = *p;
+			if (c < 0x80) {
+				*out++ = Char(c);
+				p++;
+				continue;
+			}
+			char32_t code;
+			if (!decodeUtf8(p, end, code)) {
+				throw std::runtime_error("Invalid UTF-8 sequence encountered during conversion.");
+			}
+			if constexpr (sizeof(Char) == 2) {
+				if (code >= 0x10000) {
+					code -= 0x10000;
+					*out++ = Char(0xD800 + (code >> 10));
+					*out++ = Char(0xDC00 + (code & 0x3FF));
+					continue;
+				}
+			}
+			*out++ = Char(code);
+		}
+		return out;
+	}
+
+	// 将 UTF-16 或 UTF-32 码元编码为 UTF-8，返回写入的末尾。
+	// 输出至少要能容纳 (end - p) * 4 个字节，UTF-16 时为 (end - p) * 3 个。Simd 的含义同上。
+	template <typename Char, bool Simd = bool(CHH_USE_SSE2)>
+	static char* encodeUtf8(const Char* p, const Char* end, char* out) {
+		while (p < end) {
+#if CHH_USE_SSE2
+			// 连续的 ASCII 码元一次收窄。
+			if constexpr (Simd && sizeof(Char) == 2) {
+				if (end - p >= 8) {
+					const __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+					const __m128i high = _mm_and_si128(units, _mm_set1_epi16(-0x80));
+					if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, _mm_setzero_si128())) == 0xFFFF) {
+						_mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(units, units));
+						p += 8;
+						out += 8;
+						continue;
+					}
+				}
+			}
+			else if constexpr (Simd) {
+				if (end - p >= 4) {
+					const __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+					const __m128i high = _mm_and_si128(units, _mm_set1_epi32(-0x80));
+					if (_mm_movemask_epi8(_mm_cmpeq_epi32(high, _mm_setzero_si128())) == 0xFFFF) {
+						const __m128i words = _mm_packs_epi32(units, units);
+						const int bytes = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+						std::memcpy(out, &bytes, 4);
+						p += 4;
+						out += 4;
+						continue;
+					}
+				}
+			}
+#endif
+			// 先转成无符号类型，Linux 上 wchar_t 是有符号的。
+			char32_t code = char32_t(std::make_unsigned_t<Char>(*p++));
+			if constexpr (sizeof(Char) == 2) {
+				if (code >= 0xD800 && code <= 0xDBFF && p < end && *p >= 0xDC00 && *p <= 0xDFFF) {
+					code = 0x10000 + ((code - 0xD800) << 10) + (char32_t(*p++) - 0xDC00);
+				}
+			}
+			if ((code >= 0xD800 && code <= 0xDFFF) || code > 0x10FFFF) {
+				throw std::runtime_error("Invalid wide character encountered during conversion.");
+			}
+			if (code < 0x80) {
+				*out++ = char(code);
+			}
+			else if (code < 0x800) {
+				*out++ = char(0xC0 | (code >> 6));
+				*out++ = char(0x80 | (code & 0x3F));
+			}
+			else if (code < 0x10000) {
+				*out++ = char(0xE0 | (code >> 12));
+				*out++ = char(0x80 | ((code >> 6) & 0x3F));
+				*out++ = char(0x80 | (code & 0x3F));
+			}
+			else {
+				*out++ = char(0xF0 | (code >> 18));
+				*out++ = char(0x80 | ((code >> 12) & 0x3F));
+				*out++ = char(0x80 | ((code >> 6) & 0x3F));
+				*out++ = char(0x80 | (code & 0x3F));
+			}
+		}
+		return out;
+	}
+
+	template <typename Char>
+	static std::string encodeUtf8(std::basic_string_view<Char> str) {
+		std::string result(str.size() * (sizeof(Char) == 2 ? 3 : 4), 0);
+		result.resize(encodeUtf8(str.data(), str.data() + str.size(), result.data()) - result.data());
+		return result;
+	}
+
+	template <typename Char>
+	static std::basic_string<Char> decodeUtf8(std::string_view str) {
+		std::basic_string<Char> result(str.size(), 0);
+		result.resize(decodeUtf8(str.data(), str.data() + str.size(), result.data()) - result.data());
+		return result;
+	}
+
 	std::string toString(const std::wstring& wstr) {
-		if (wstr.empty()) return std::string();
-		size_t size_needed = std::wcstombs(nullptr, wstr.c_str(), 0);
-		if (size_needed == static_cast<size_t>(-1)) {
-			throw std::runtime_error("Invalid wide character encountered during conversion.");
+		return encodeUtf8(std::wstring_view(wstr));
+	}
+
+	std::string toString(std::u16string_view str) {
+		return encodeUtf8(str);
+	}
+
+	std::string toString(std::u32string_view str) {
+		return encodeUtf8(str);
+	}
+
+	std::wstring toWString(std::string_view str) {
+		return decodeUtf8<wchar_t>(str);
+	}
+
+	std::u16string toU16String(std::string_view str) {
+		return decodeUtf8<char16_t>(str);
+	}
+
+	std::u32string toU32String(std::string_view str) {
+		return decodeUtf8<char32_t>(str);
+	}
+
+	void appendUtf8(std::string& str, char32_t code) {
+		char bytes[4];
+		str.append(bytes, encodeUtf8(&code, &code + 1, bytes) - bytes);
+	}
+
+	// 按起点排序的闭区间表，取自 Unicode 的 East Asian Width 和 General Category。
+	struct CodeRange { char32_t first, last; };
+
+	static const CodeRange zeroWidthRanges[] = {
+		{ 0x0300, 0x036F }, { 0x0483, 0x0489 }, { 0x0591, 0x05BD }, { 0x05BF, 0x05BF },
+		{ 0x05C1, 0x05C2 }, { 0x05C4, 0x05C5 }, { 0x05C7, 0x05C7 }, { 0x0610, 0x061A },
+		{ 0x064B, 0x065F }, { 0x0670, 0x0670 }, { 0x06D6, 0x06DC }, { 0x06DF, 0x06E4 },
+		{ 0x06E7, 0x06E8 }, { 0x06EA, 0x06ED }, { 0x0900, 0x0902 }, { 0x093A, 0x093A },
+		{ 0x093C, 0x093C }, { 0x0941, 0x0948 }, { 0x094D, 0x094D }, { 0x0951, 0x0957 },
+		{ 0x0E31, 0x0E31 }, { 0x0E34, 0x0E3A }, { 0x0E47, 0x0E4E }, { 0x1160, 0x11FF },
+		{ 0x1AB0, 0x1AFF }, { 0x1DC0, 0x1DFF }, { 0x200B, 0x200F }, { 0x202A, 0x202E },
+		{ 0x2060, 0x2064 }, { 0x20D0, 0x20FF }, { 0x302A, 0x302D }, { 0x3099, 0x309A },
+		{ 0xFE00, 0xFE0F }, { 0xFE20, 0xFE2F }, { 0xFEFF, 0xFEFF }, { 0xE0001, 0xE0001 },
+		{ 0xE0020, 0xE007F }, { 0xE0100, 0xE01EF },
+	};
+
+	static const CodeRange wideRanges[] = {
+		{ 0x1100, 0x115F }, { 0x231A, 0x231B }, { 0x2329, 0x232A }, { 0x23E9, 0x23EC },
+		{ 0x23F0, 0x23F0 }, { 0x23F3, 0x23F3 }, { 0x25FD, 0x25FE }, { 0x2614, 0x2615 },
+		{ 0x2648, 0x2653 }, { 0x267F, 0x267F }, { 0x2693, 0x2693 }, { 0x26A1, 0x26A1 },
+		{ 0x26AA, 0x26AB }, { 0x26BD, 0x26BE }, { 0x26C4, 0x26C5 }, { 0x26CE, 0x26CE },
+		{ 0x26D4, 0x26D4 }, { 0x26EA, 0x26EA }, { 0x26F2, 0x26F3 }, { 0x26F5, 0x26F5 },
+		{ 0x26FA, 0x26FA }, { 0x26FD, 0x26FD }, { 0x2705, 0x2705 }, { 0x270A, 0x270B },
+		{ 0x2728, 0x2728 }, { 0x274C, 0x274C }, { 0x274E, 0x274E }, { 0x2753, 0x2755 },
+		{ 0x2757, 0x2757 }, { 0x2795, 0x2797 }, { 0x27B0, 0x27B0 }, { 0x27BF, 0x27BF },
+		{ 0x2B1B, 0x2B1C }, { 0x2B50, 0x2B50 }, { 0x2B55, 0x2B55 }, { 0x2E80, 0x303E },
+		{ 0x3041, 0x33FF }, { 0x3400, 0x4DBF }, { 0x4E00, 0x9FFF }, { 0xA000, 0xA4CF },
+		{ 0xA960, 0xA97F }, { 0xAC00, 0xD7A3 }, { 0xF900, 0xFAFF }, { 0xFE10, 0xFE19 },
+		{ 0xFE30, 0xFE6F }, { 0xFF00, 0xFF60 }, { 0xFFE0, 0xFFE6 }, { 0x16FE0, 0x16FE4 },
+		{ 0x17000, 0x18CFF }, { 0x1B000, 0x1B2FF }, { 0x1F004, 0x1F004 }, { 0x1F0CF, 0x1F0CF },
+		{ 0x1F18E, 0x1F18E }, { 0x1F191, 0x1F19A }, { 0x1F200, 0x1F251 }, { 0x1F300, 0x1F320 },
+		{ 0x1F32D, 0x1F335 }, { 0x1F337, 0x1F37C }, { 0x1F37E, 0x1F393 }, { 0x1F3A0, 0x1F3CA },
+		{ 0x1F3CF, 0x1F3D3 }, { 0x1F3E0, 0x1F3F0 }, { 0x1F3F4, 0x1F3F4 }, { 0x1F3F8, 0x1F43E },
+		{ 0x1F440, 0x1F440 }, { 0x1F442, 0x1F4FC }, { 0x1F4FF, 0x1F53D }, { 0x1F54B, 0x1F54E },
+		{ 0x1F550, 0x1F567 }, { 0x1F57A, 0x1F57A }, { 0x1F595, 0x1F596 }, { 0x1F5A4, 0x1F5A4 },
+		{ 0x1F5FB, 0x1F64F }, { 0x1F680, 0x1F6C5 }, { 0x1F6CC, 0x1F6CC }, { 0x1F6D0, 0x1F6D2 },
+		{ 0x1F6D5, 0x1F6D7 }, { 0x1F6EB, 0x1F6EC }, { 0x1F6F4, 0x1F6FC }, { 0x1F7E0, 0x1F7EB },
+		{ 0x1F90C, 0x1F93A }, { 0x1F93C, 0x1F945 }, { 0x1F947, 0x1F9FF }, { 0x1FA70, 0x1FAFF },
+		{ 0x20000, 0x2FFFD }, { 0x30000, 0x3FFFD },
+	};
+
+	template <size_t N>
+	static bool inRanges(const CodeRange (&ranges)[N], char32_t code) {
+		if (code < ranges[0].first || code > ranges[N - 1].last) return false;
+		auto it = std::upper_bound(ranges, ranges + N, code, [](char32_t c, const CodeRange& r) { return c < r.first; });
+		return it != ranges && code <= (it - 1)->last;
+	}
+
+	int displayWidth(char32_t code) {
+		if (code < 0x300) return 1;
+		if (inRanges(zeroWidthRanges, code)) return 0;
+		if (inRanges(wideRanges, code)) return 2;
+		return 1;
+	}
+
+	char32_t nextUtf8(std::string_view str, size_t& pos) {
+		const char* p = str.data() + pos;
+		char32_t code;
+		if (!decodeUtf8(p, str.data() + str.size(), code)) {
+			pos++;
+			return 0xFFFD;
 		}
-		std::string str(size_needed, 0);
-		std::wcstombs(str.data(), wstr.c_str(), size_needed);
-		return str;
+		pos = p - str.data();
+		return code;
 	}
 
-	std::wstring toWString(const std::string& str) {
-		if (str.empty()) return std::wstring();
-		size_t size_needed = std::mbstowcs(nullptr, str.c_str(), 0);
-		if (size_needed == static_cast<size_t>(-1)) {
-			throw std::runtime_error("Invalid character encountered during conversion.");
+	size_t displayWidth(std::string_view str) {
+		size_t width = 0;
+		for (size_t pos = 0; pos < str.size();) {
+			if ((unsigned char)str[pos] < 0x80) {
+				width++;
+				pos++;
+			}
+			else width += displayWidth(nextUtf8(str, pos));
 		}
-		std::wstring wstr(size_needed, 0);
-		std::mbstowcs(wstr.data(), str.c_str(), size_needed);
-		return wstr;
+		return width;
 	}
 
 	std::vector<char> readFile(const std::string& file_name) {
@@ -49,6 +301,169 @@ namespace chh {
 		}
 	}
 
+#if CHH_IS_WINDOWS
+	MappedFile::MappedFile(const std::string& file_name) : _data(nullptr), _size(0), _mapping(NULL) {
+		HANDLE file = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE) {
+			throw std::runtime_error("Unable to open file: " + file_name + ".");
+		}
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size)) {
+			CloseHandle(file);
+			throw std::runtime_error("Unable to get file size: " + file_name + ".");
+		}
+		this->_size = size_t(size.QuadPart);
+		if (this->_size == 0) { // 空文件不能映射。
+			CloseHandle(file);
+			return;
+		}
+		this->_mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		CloseHandle(file);
+		if (!this->_mapping) {
+			throw std::runtime_error("Unable to map file: " + file_name + ".");
+		}
+		this->_data = (const char*)MapViewOfFile(this->_mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!this->_data) {
+			CloseHandle(this->_mapping);
+			throw std::runtime_error("Unable to map file: " + file_name + ".");
+		}
+	}
+
+	MappedFile::~MappedFile() {
+		if (this->_data) UnmapViewOfFile(this->_data);
+		if (this->_mapping) CloseHandle(this->_mapping);
+	}
+#elif CHH_IS_LINUX
+	MappedFile::MappedFile(const std::string& file_name) : _data(nullptr), _size(0) {
+		int fd = open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0) {
+			throw std::runtime_error("Unable to open file: " + file_name + ".");
+		}
+		struct stat st;
+		if (fstat(fd, &st) != 0) {
+			close(fd);
+			throw std::runtime_error("Unable to get file size: " + file_name + ".");
+		}
+		this->_size = size_t(st.st_size);
+		if (this->_size == 0) { // 空文件不能映射。
+			close(fd);
+			return;
+		}
+		void* data = mmap(nullptr, this->_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (data == MAP_FAILED) {
+			throw std::runtime_error("Unable to map file: " + file_name + ".");
+		}
+		this->_data = (const char*)data;
+	}
+
+	MappedFile::~MappedFile() {
+		if (this->_data) munmap((void*)this->_data, this->_size);
+	}
+#endif
+
+	const char* MappedFile::data() const { return this->_data; }
+
+	size_t MappedFile::size() const { return this->_size; }
+
+	std::string_view MappedFile::view() const {
+		return std::string_view(this->_data, this->_size);
+	}
+
+#if CHH_IS_WINDOWS
+	// 获取文件的修改时间，文件不存在时为 0。
+	static FILETIME lastWriteTime(const std::string& file_name) {
+		WIN32_FILE_ATTRIBUTE_DATA data;
+		if (!GetFileAttributesExA(file_name.c_str(), GetFileExInfoStandard, &data)) return FILETIME{ 0, 0 };
+		return data.ftLastWriteTime;
+	}
+
+	FileWatcher::FileWatcher(const std::string& file_name, std::function<void()> callback)
+		: _file_name(file_name), _callback(callback), _time(lastWriteTime(file_name)) {
+		std::string directory = std::filesystem::path(file_name).parent_path().string();
+		if (directory.empty()) directory = ".";
+		this->_change = FindFirstChangeNotificationA(directory.c_str(), FALSE,
+			FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+		if (this->_change == INVALID_HANDLE_VALUE) {
+			throw std::runtime_error("Unable to watch file: " + file_name + ".");
+		}
+		this->_stop = CreateEventA(NULL, TRUE, FALSE, NULL);
+		if (!this->_stop) {
+			FindCloseChangeNotification(this->_change);
+			throw std::runtime_error("Unable to watch file: " + file_name + ".");
+		}
+		this->_thread = std::thread(&FileWatcher::run, this);
+	}
+
+	FileWatcher::~FileWatcher() {
+		SetEvent(this->_stop);
+		this->_thread.join();
+		FindCloseChangeNotification(this->_change);
+		CloseHandle(this->_stop);
+	}
+
+	void FileWatcher::run() {
+		HANDLE handles[2] = { this->_change, this->_stop };
+		while (WaitForMultipleObjects(2, handles, FALSE, INFINITE) == WAIT_OBJECT_0) {
+			FindNextChangeNotification(this->_change);
+			// 目录里的其他文件变化也会通知，比较修改时间过滤掉。
+			FILETIME time = lastWriteTime(this->_file_name);
+			if (CompareFileTime(&time, &this->_time) == 0) continue;
+			this->_time = time;
+			this->_callback();
+		}
+	}
+#elif CHH_IS_LINUX
+	FileWatcher::FileWatcher(const std::string& file_name, std::function<void()> callback)
+		: _file_name(std::filesystem::path(file_name).filename().string()), _callback(callback) {
+		std::string directory = std::filesystem::path(file_name).parent_path().string();
+		if (directory.empty()) directory = ".";
+		this->_inotify = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+		if (this->_inotify < 0) {
+			throw std::runtime_error("Unable to watch file: " + file_name + ".");
+		}
+		if (inotify_add_watch(this->_inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0 ||
+			pipe(this->_stop) != 0) {
+			close(this->_inotify);
+			throw std::runtime_error("Unable to watch file: " + file_name + ".");
+		}
+		this->_thread = std::thread(&FileWatcher::run, this);
+	}
+
+	FileWatcher::~FileWatcher() {
+		char c = 0;
+		while (write(this->_stop[1], &c, 1) < 0 && errno == EINTR);
+		this->_thread.join();
+		close(this->_stop[0]);
+		close(this->_stop[1]);
+		close(this->_inotify);
+	}
+
+	void FileWatcher::run() {
+		alignas(inotify_event) char buffer[4096];
+		pollfd fds[2] = { { this->_inotify, POLLIN, 0 }, { this->_stop[0], POLLIN, 0 } };
+		while (true) {
+			if (poll(fds, 2, -1) < 0) {
+				if (errno == EINTR) continue;
+				return;
+			}
+			if (fds[1].revents) return;
+			// 读完所有积压的事件，只要有一个是这个文件就回调一次。
+			bool changed = false;
+			ssize_t size;
+			while ((size = read(this->_inotify, buffer, sizeof(buffer))) > 0) {
+				for (char* i = buffer; i < buffer + size;) {
+					const inotify_event* event = (const inotify_event*)i;
+					if (event->len && this->_file_name == event->name) changed = true;
+					i += sizeof(inotify_event) + event->len;
+				}
+			}
+			if (changed) this->_callback();
+		}
+	}
+#endif
+
 #if CHH_IS_WINDOWS
 	std::vector<char> readResource(const size_t& name, const std::string& type) {
 		HRSRC hRsrc = FindResourceA(NULL, MAKEINTRESOURCEA(name), type.c_str());
@@ -73,17 +488,65 @@ namespace chh {
 		FreeResource(IDR);
 		return vec;
 	}
+#elif CHH_IS_LINUX
+	// 资源登记表。
+	// 登记发生在静态初始化期间，用函数内的静态变量避免初始化顺序的问题。
+	struct ResourceTable {
+		std::mutex mtx;
+		std::map<std::string, std::string_view> resources;
+	};
+
+	static ResourceTable& resourceTable() {
+		static ResourceTable table;
+		return table;
+	}
+
+	void registerResource(const std::string& name, std::string_view data) {
+		auto& table = resourceTable();
+		std::lock_guard<std::mutex> lock(table.mtx);
+		table.resources[name] = data;
+	}
+
+	std::string_view viewResource(const std::string& name) {
+		auto& table = resourceTable();
+		std::lock_guard<std::mutex> lock(table.mtx);
+		auto it = table.resources.find(name);
+		if (it == table.resources.end()) {
+			throw std::runtime_error("Failed to find resource: " + name + ".");
+		}
+		return it->second;
+	}
 #endif
 
-	Json::Value parseJson(const std::string& content) {
+	Json::Value parseJson(std::string_view content) {
+		Json::Value root;
+		Json::CharReaderBuilder reader;
+		std::unique_ptr<Json::CharReader> parser(reader.newCharReader());
+		std::string errs;
+		if (!parser->parse(content.data(), content.data() + content.size(), &root, &errs)) {
+			throw std::runtime_error("Failed to parse JSON: \n" + errs);
+		}
+		return root;
+	}
+
+	Json::Value parseJsonInSitu(std::string& content) {
 		Json::Value root;
 		Json::CharReaderBuilder reader;
 		std::unique_ptr<Json::CharReader> parser(reader.newCharReader());
 		std::string errs;
-		if (!parser->parse(content.c_str(), content.c_str() + content.size(), &root, &errs)) {
+		if (!parser->parseInSitu(content.data(), content.data() + content.size(), &root, &errs)) {
 			throw std::runtime_error("Failed to parse JSON: \n" + errs);
 		}
 		return root;
 	}
 
+	void parseJson(std::string_view content, Json::ParseHandler& handler) {
+		Json::CharReaderBuilder reader;
+		std::unique_ptr<Json::CharReader> parser(reader.newCharReader());
+		std::string errs;
+		if (!parser->parseEvents(content.data(), content.data() + content.size(), handler, &errs)) {
+			throw std::runtime_error("Failed to parse JSON: \n" + errs);
+		}
+	}
+
 }
\ No newline at end of file
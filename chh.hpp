@@ -1,13 +1,20 @@
 ﻿#pragma once
 
 #include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <queue>
 #include <vector>
 #include <list>
+#include <deque>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <optional>
+#include <string_view>
 #include <any>
 #include <variant>
 #include <functional>
@@ -17,6 +24,10 @@
 #include <mutex>
 #include <shared_mutex>
 #include <future>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <memory>
 
 #if defined _WIN32
 #include <Windows.h>
@@ -30,6 +41,10 @@
 #include <termios.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+#include <poll.h>
 #define CHH_IS_WINDOWS 0
 #define CHH_IS_LINUX 1
 #define sleep_ms usleep
@@ -37,21 +52,108 @@
 
 #include <json/json.h>
 
+#if CHH_IS_LINUX
+// 登记由构建步骤嵌入的资源，只能在全局作用域使用
+// 用 `tools/embed_resources.sh lang.o lang/zh.json` 生成只读段中的目标文件并链接，
+// 脚本会输出每个文件对应的 symbol，这里即 zh_json。
+#define CHH_RESOURCE(name, symbol) \
+	extern "C" const char _binary_##symbol##_start[]; \
+	extern "C" const char _binary_##symbol##_end[]; \
+	static const bool chh_resource_##symbol = (chh::registerResource(name, std::string_view( \
+		_binary_##symbol##_start, size_t(_binary_##symbol##_end - _binary_##symbol##_start))), true);
+#endif
+
 // 一个轻量级的 C++ 工具箱
 namespace chh {
 
 	// 将字符向量转换为字符串
 	std::string toString(const std::vector<char>& vec);
 
-	// 将宽字符串转换为窄字符串
+	// 将宽字符串转换为 UTF-8 字符串
+	// 宽字符在 Windows 上按 UTF-16、在 Linux 上按 UTF-32 解释，与区域设置无关。
 	std::string toString(const std::wstring& wstr);
 
-	// 将窄字符串转换为宽字符串
-	std::wstring toWString(const std::string& str);
+	// 将 UTF-16 字符串转换为 UTF-8 字符串，遇到不成对的代理项时抛出异常
+	std::string toString(std::u16string_view str);
+
+	// 将 UTF-32 字符串转换为 UTF-8 字符串，遇到无效码点时抛出异常
+	std::string toString(std::u32string_view str);
+
+	// 将 UTF-8 字符串转换为宽字符串，与区域设置无关
+	std::wstring toWString(std::string_view str);
+
+	// 将 UTF-8 字符串转换为 UTF-16 字符串，遇到无效编码时抛出异常
+	std::u16string toU16String(std::string_view str);
+
+	// 将 UTF-8 字符串转换为 UTF-32 字符串，遇到无效编码时抛出异常
+	std::u32string toU32String(std::string_view str);
+
+	// 将一个 Unicode 码点以 UTF-8 编码追加到字符串，遇到无效码点时抛出异常
+	void appendUtf8(std::string& str, char32_t code);
+
+	// 一个 Unicode 码点在终端上占的列数
+	// 中日韩文字等宽字符占 2 列，组合字符和零宽字符占 0 列，其余占 1 列。
+	int displayWidth(char32_t code);
+
+	// 解码 str 中 pos 处的一个码点，并把 pos 移到下一个码点
+	// 不抛出异常：无效或截断的编码返回 U+FFFD，pos 只前进一个字节。
+	char32_t nextUtf8(std::string_view str, size_t& pos);
+
+	// 一个 UTF-8 字符串在终端上占的列数
+	// 无效的字节按 1 列计算。
+	size_t displayWidth(std::string_view str);
 
 	// 从文件中读取字符向量
 	std::vector<char> readFile(const std::string& file_name);
 
+	// 只读内存映射的文件
+	// 映射的页由页缓存提供，多个进程可以共享。view() 可以直接交给 parseJson，不必先读入内存。
+	class MappedFile {
+		const char* _data;
+		size_t _size;
+#if CHH_IS_WINDOWS
+		HANDLE _mapping;
+#endif
+	public:
+		// 映射整个文件
+		MappedFile(const std::string& file_name);
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		~MappedFile();
+		// 获取数据
+		const char* data() const;
+		// 获取大小
+		size_t size() const;
+		// 获取整个文件的视图
+		std::string_view view() const;
+	};
+
+	// 监视文件变化
+	// 在后台线程等待系统通知，不轮询。监视的是所在目录，所以编辑器先写临时文件再替换也能发现。
+	// 回调在后台线程执行，连续的多次变化只回调一次。
+	class FileWatcher {
+		std::string _file_name;
+		std::function<void()> _callback;
+		std::thread _thread;
+#if CHH_IS_WINDOWS
+		HANDLE _change;
+		HANDLE _stop;
+		FILETIME _time;
+#elif CHH_IS_LINUX
+		int _inotify;
+		// 写入一端即可唤醒后台线程退出。
+		int _stop[2];
+#endif
+		void run();
+	public:
+		// 开始监视
+		FileWatcher(const std::string& file_name, std::function<void()> callback);
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher& operator=(const FileWatcher&) = delete;
+		// 停止监视，等待正在执行的回调结束
+		~FileWatcher();
+	};
+
 #if CHH_IS_WINDOWS
 	// 从 Windows 资源中读取字符向量
 	// 该函数仅在 Windows 平台上可用。
@@ -60,9 +162,82 @@ namespace chh {
 	// 从 Windows 资源中读取字符向量
 	// 该函数在 Linux 平台上不可用。
 	std::vector<char> readResource(const size_t& name, const std::string& type) = delete;
+
+	// 登记嵌入程序的资源
+	// 该函数仅在 Linux 平台上可用。通常通过 CHH_RESOURCE 在程序启动时调用，data 必须在程序运行期间有效。
+	void registerResource(const std::string& name, std::string_view data);
+
+	// 获取嵌入程序的资源
+	// 该函数仅在 Linux 平台上可用。返回的视图直接指向程序映像，不复制。找不到时抛出 std::runtime_error。
+	std::string_view viewResource(const std::string& name);
 #endif
 
 	// 从 JSON 字符串中解析对象
-	Json::Value parseJson(const std::string& content);
+	Json::Value parseJson(std::string_view content);
+
+	// 就地解析 JSON 字符串
+	// 字符串值在 content 内解码，结果直接引用 content 而不复制；content 会被修改，且必须比结果及其副本活得久。
+	Json::Value parseJsonInSitu(std::string& content);
+
+	// 流式解析 JSON 字符串
+	// 不构建 Json::Value，解析到的内容依次交给 handler。失败时抛出 std::runtime_error。
+	void parseJson(std::string_view content, Json::ParseHandler& handler);
+
+	// 有界的多生产者、单消费者无锁环形队列
+	// 队列满时 push 直接失败，由调用方决定是否丢弃。
+	template <typename T>
+	class RingQueue {
+		struct Slot {
+			std::atomic<size_t> seq;
+			T value;
+		};
+		std::unique_ptr<Slot[]> _slots;
+		size_t _mask;
+		alignas(64) std::atomic<size_t> _tail;
+		alignas(64) size_t _head;
+	public:
+		// 容量会向上取整到 2 的幂。
+		explicit RingQueue(size_t capacity) : _tail(0), _head(0) {
+			size_t size = 1;
+			while (size < capacity) size <<= 1;
+			this->_slots.reset(new Slot[size]);
+			this->_mask = size - 1;
+			for (size_t i = 0; i < size; i++) {
+				this->_slots[i].seq.store(i, std::memory_order_relaxed);
+			}
+		}
+		RingQueue(const RingQueue&) = delete;
+		RingQueue& operator=(const RingQueue&) = delete;
+		// 获取容量
+		size_t capacity() const { return this->_mask + 1; }
+		// 放入一个元素
+		// 任意线程都可以调用，队列满时返回 false。
+		bool push(T&& value) {
+			size_t pos = this->_tail.load(std::memory_order_relaxed);
+			while (true) {
+				Slot& slot = this->_slots[pos & this->_mask];
+				size_t seq = slot.seq.load(std::memory_order_acquire);
+				if (seq == pos) {
+					if (this->_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						slot.value = std::move(value);
+						slot.seq.store(pos + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (seq < pos) return false; // 满了。
+				else pos = this->_tail.load(std::memory_order_relaxed);
+			}
+		}
+		// 取出一个元素
+		// 只能由唯一的消费者线程调用，队列空时返回 false。
+		bool pop(T& value) {
+			Slot& slot = this->_slots[this->_head & this->_mask];
+			if (slot.seq.load(std::memory_order_acquire) != this->_head + 1) return false;
+			value = std::move(slot.value);
+			slot.seq.store(this->_head + this->_mask + 1, std::memory_order_release);
+			this->_head++;
+			return true;
+		}
+	};
 
 }
\ No newline at end of file
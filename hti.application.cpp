@@ -36,7 +36,7 @@ namespace hti {
 
 #if CHH_IS_WINDOWS
 	Application::Application()
-		: Widget(NULL), _should_exit(false), _thrd_id(std::this_thread::get_id()) {
+		: Widget(NULL), _should_exit(false), _dirty(false), _thrd_id(std::this_thread::get_id()) {
 		this->_ihandle = GetStdHandle(STD_INPUT_HANDLE);
 		this->_ohandle = GetStdHandle(STD_OUTPUT_HANDLE);
 		HWND hWnd = GetConsoleWindow();
@@ -56,8 +56,7 @@ namespace hti {
 	}
 #elif CHH_IS_LINUX
 	Application::Application()
-		: Widget(NULL), _should_exit(false), _displaying(0), _focus(0), _thrd_id(std::this_thread::get_id()) {
-		setlocale(LC_ALL, "zh_cn.utf8");
+		: Widget(NULL), _should_exit(false), _dirty(false), _displaying(0), _focus(0), _thrd_id(std::this_thread::get_id()) {
 	}
 #endif
 
@@ -121,6 +120,10 @@ namespace hti {
 		}
 	}
 
+	void Application::markDirty() {
+		this->_dirty.store(true, std::memory_order_release);
+	}
+
 	std::string Application::onRender(bool focus) {
 		if (this->children().size() != 1) return "";
 		if (!this->children().front()->visible()) return "";
@@ -134,34 +137,51 @@ namespace hti {
 	}
 
 	void Application::render() {
-		printf("\033[H"); // 移动光标到 (0, 0) 。
 		std::string temp = this->onRender(true) + "\n";
 		int width, height;
 		getConsoleSize(width, height);
-		// 用空格填充每一行。
-		char* buffer = new char[width + 1];
-		memset(buffer, ' ', width);
-		buffer[width] = 0;
-		int y = 0, x = 0;
-		std::ostringstream oss;
-		for (const auto& i : temp) {
-			if (y >= height - 1) break;
-			switch (i) {
+		// 每一列存一个字符的 UTF-8 字节，不足的用空格填充。
+		// 宽字符占两列，第二列留空；组合字符不占列，拼到前一个字符上。
+		std::vector<std::string> cells(std::max(width, 0), " ");
+		std::vector<std::string> lines;
+		int x = 0;
+		auto newline = [&]() {
+			std::string line;
+			line.reserve(cells.size());
+			for (auto& c : cells) {
+				line += c;
+				c = " ";
+			}
+			lines.push_back(std::move(line));
+		};
+		for (size_t i = 0; i < temp.size();) {
+			if (int(lines.size()) >= height - 1) break;
+			const size_t start = i;
+			// 解码一个码点，无效的字节按单列的单个字符处理。
+			const char32_t code = chh::nextUtf8(temp, i);
+			switch (code) {
 			default: {
-				if (x >= width); // fallthrough 到换行。
+				const std::string_view bytes(temp.data() + start, i - start);
+				const int w = chh::displayWidth(code);
+				if (w == 0) {
+					if (x > 0) cells[cells[x - 1].empty() && x > 1 ? x - 2 : x - 1] += bytes;
+					break;
+				}
+				if (x + w > width); // fallthrough 到换行。
 				else {
-					buffer[x] = i;
-					x++;
+					// 覆盖了宽字符的一半时，另一半换成空格。
+					if (cells[x].empty()) cells[x - 1] = " ";
+					if (x + w < width && cells[x + w].empty()) cells[x + w] = " ";
+					cells[x] = bytes;
+					if (w == 2) cells[x + 1].clear();
+					x += w;
 					break;
 				}
 				[[fallthrough]];
 			}
 			case '\n': {
-				oss << buffer << "\n";
-				memset(buffer, ' ', width);
-				buffer[width] = 0;
-				y++;
-				// 挺有趣的：y++ 相当于 \n, x=0 相当于 \r。
+				newline();
+				// 挺有趣的：newline() 相当于 \n, x=0 相当于 \r。
 				[[fallthrough]];
 			}
 			case '\r': {
@@ -169,26 +189,105 @@ namespace hti {
 				break;
 			}
 			case '\b': {
-				x--;
+				if (x > 0) x--;
 				break;
 			}
 			}
 		}
-		printf("%s", oss.str().c_str());
-		memset(buffer, ' ', width);
-		buffer[width] = 0;
-		while (true) {
-			if (y >= height - 1) break;
-			printf("%s", buffer);
-			y++;
+		while (int(lines.size()) < height - 1) newline();
+		this->present(lines, width);
+	}
+
+	void Application::present(std::vector<std::string>& lines, int width) {
+		const size_t n = lines.size();
+		std::vector<size_t> hashes(n);
+		for (size_t i = 0; i < n; i++) hashes[i] = std::hash<std::string>{}(lines[i]);
+		// 尺寸变了，上一帧作废，全部重画。
+		if (this->_frame.size() != n || this->_frame_width != width) {
+			this->_frame.assign(n, std::string());
+			this->_frame_hash.assign(n, 0);
+			this->_frame_width = width;
 		}
+		auto& old = this->_frame;
+		auto& old_hash = this->_frame_hash;
+		auto same = [&](size_t i, size_t j) {
+			return hashes[i] == old_hash[j] && old[j].size() == lines[i].size();
+		};
+		std::string out;
+		// 找出发生变化的区域 [top, bottom)。
+		size_t top = 0, bottom = n;
+		while (top < n && same(top, top)) top++;
+		while (bottom > top && same(bottom - 1, bottom - 1)) bottom--;
+		// 在变化区域里找一个整体的竖直位移（比如日志滚动了一行）。
+		// 正数表示内容上移（CSI S），负数表示下移（CSI T）。
+		if (bottom - top >= 3) {
+			size_t base = 0;
+			for (size_t i = top; i < bottom; i++) if (same(i, i)) base++;
+			size_t best = base + 1; // 至少要多省一行才值得滚动。
+			long shift = 0;
+			for (size_t k = 1; k < bottom - top; k++) {
+				size_t up = 0, down = 0;
+				for (size_t i = top; i + k < bottom; i++) {
+					if (same(i, i + k)) up++;
+					if (same(i + k, i)) down++;
+				}
+				if (up > best) { best = up; shift = long(k); }
+				if (down > best) { best = down; shift = -long(k); }
+			}
+			if (shift != 0) {
+				size_t k = size_t(shift > 0 ? shift : -shift);
+				// DECSTBM 设置滚动区域，滚动后再恢复为全屏。
+				out += "\033[" + std::to_string(top + 1) + ";" + std::to_string(bottom) + "r";
+				out += "\033[" + std::to_string(k) + (shift > 0 ? "S" : "T");
+				out += "\033[r";
+				// 同步更新上一帧，新露出来的行是空白的。
+				const std::string blank(std::max(width, 0), ' ');
+				if (shift > 0) {
+					for (size_t i = top; i < bottom; i++) {
+						if (i + k < bottom) {
+							old[i] = std::move(old[i + k]);
+							old_hash[i] = old_hash[i + k];
+						}
+						else {
+							old[i] = blank;
+							old_hash[i] = std::hash<std::string>{}(blank);
+						}
+					}
+				}
+				else {
+					for (size_t i = bottom; i-- > top;) {
+						if (i >= top + k) {
+							old[i] = std::move(old[i - k]);
+							old_hash[i] = old_hash[i - k];
+						}
+						else {
+							old[i] = blank;
+							old_hash[i] = std::hash<std::string>{}(blank);
+						}
+					}
+				}
+			}
+		}
+		// 只重画内容不同的行。
+		for (size_t i = top; i < bottom; i++) {
+			if (old[i] == lines[i]) continue;
+			out += "\033[" + std::to_string(i + 1) + ";1H";
+			out += lines[i];
+		}
+		this->_frame.swap(lines);
+		this->_frame_hash.swap(hashes);
+		if (out.empty()) return;
+		fwrite(out.data(), 1, out.size(), stdout);
+		fflush(stdout);
 	}
 
 	void hti::Application::mainloop() {
 		if (!_should_exit) this->render(); // 先渲染。
 		Key key;
 		while (!_should_exit) {
-			if (this->processEvent()) this->render(); // 有事件时刷新。
+			bool dirty = this->processEvent(); // 有事件时刷新。
+			if (this->_dirty.exchange(false, std::memory_order_acq_rel)) dirty = true;
+			if (dirty) this->render();
 			if (!(key = this->getch()).isNone()) {
 				this->onKeyPress(key);
 				this->render(); // 处理按键后刷新。
@@ -219,18 +318,140 @@ namespace hti {
 	}
 
 	void Application::loadLanguageFromFile(const std::string& name, const std::string& file_name) {
-		this->_languages.load(name, chh::toString(chh::readFile(file_name)));
+		chh::MappedFile file(file_name);
+		this->_languages.load(name, file.view());
+	}
+
+	void Application::loadLanguageFromCatalog(const std::string& name, const std::string& file_name) {
+		auto file = std::make_shared<const chh::MappedFile>(file_name);
+		this->_languages.load(name, i18n::Language::fromCatalog(file->view(), file));
+	}
+
+	void Application::registerLanguage(const std::string& name, const std::string& content) {
+		this->_languages.source(name, [content]() {
+			return i18n::Language(content);
+			});
+	}
+
+	void Application::registerLanguageFromFile(const std::string& name, const std::string& file_name) {
+		this->_languages.source(name, [file_name]() {
+			// 来源可能在任何时候才被调用，那时文件可能正被改写，映射的页在截断后访问会出错，所以读一份副本。
+			std::vector<char> data = chh::readFile(file_name);
+			return i18n::Language(std::string_view(data.data(), data.size()));
+			});
+	}
+
+	void Application::registerLanguageFromCatalog(const std::string& name, const std::string& file_name) {
+		this->_languages.source(name, [file_name]() {
+			auto file = std::make_shared<const chh::MappedFile>(file_name);
+			return i18n::Language::fromCatalog(file->view(), file);
+			});
+	}
+
+	void Application::registerLanguageFromMemory(const std::string& name, std::string_view data) {
+		this->_languages.source(name, [data]() {
+			if (data.substr(0, 4) == "HTIL") return i18n::Language::fromCatalog(data, nullptr);
+			return i18n::Language(data);
+			});
+	}
+
+	bool Application::unloadLanguage(const std::string& name) {
+		return this->_languages.unload(name);
+	}
+
+	void Application::unloadInactiveLanguages() {
+		this->_languages.unloadInactive();
+	}
+
+	void Application::watchLanguageFile(const std::string& name, const std::string& file_name) {
+		this->loadLanguageFromFile(name, file_name);
+		this->_language_watchers[name] = std::make_unique<chh::FileWatcher>(file_name, [this, name, file_name]() {
+			try {
+				// 文件可能随时被再次改写，映射的页在截断后访问会出错，所以这里读一份副本。
+				std::vector<char> data = chh::readFile(file_name);
+				this->_languages.load(name, std::string_view(data.data(), data.size()));
+			}
+			catch (const std::exception&) {
+				// 文件可能正在编辑，等下一次变化。
+				return;
+			}
+			this->markDirty();
+			});
+	}
+
+	void Application::unwatchLanguageFile(const std::string& name) {
+		this->_language_watchers.erase(name);
+	}
+
+	void Application::fallbackLanguage(const std::string& name, std::vector<std::string> fallbacks) {
+		this->_languages.fallback(name, std::move(fallbacks));
 	}
 
 #if CHH_IS_WINDOWS
 	void Application::loadLanguageFromResource(const std::string& name, const size_t& res_name, const std::string& res_type) {
-		this->_languages.load(name, chh::toString(chh::readResource(res_name, res_type)));
+		std::vector<char> data = chh::readResource(res_name, res_type);
+		this->_languages.load(name, std::string_view(data.data(), data.size()));
 	}
 #elif CHH_IS_LINUX
+	void Application::loadLanguageFromResource(const std::string& name, const std::string& res_name) {
+		std::string_view data = chh::viewResource(res_name);
+		if (data.substr(0, 4) == "HTIL") this->_languages.load(name, i18n::Language::fromCatalog(data, nullptr));
+		else this->_languages.load(name, data);
+	}
 #endif
 
 	void Application::switchLanguage(const std::string& name) {
-		this->_languages.current(name);
+		this->tryPostEvent(std::make_shared<LambdaEvent>([self = this, name](Event*) {
+			// 之前还没完成的切换一律作废。
+			const uint64_t serial = ++self->_switch_serial;
+			if (name == self->_languages.current_name()) return;
+			std::vector<const i18n::Text*> texts;
+			for (auto* widget : self->_widgets) widget->collectTexts(texts);
+			// 工作线程只接触副本：Text 的副本共享不可变的拼接部分，语言本身不可变。
+			std::vector<i18n::Text> copies;
+			copies.reserve(texts.size());
+			for (auto* text : texts) copies.push_back(*text);
+			self->_switching.remove_if([](std::future<void>& task) {
+				return task.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+				});
+			self->_switching.push_back(std::async(std::launch::async,
+				[self, name, serial, texts = std::move(texts), copies = std::move(copies)]() mutable {
+				// 语言没有加载时在这里读文件和解析，不阻塞界面线程。
+				std::shared_ptr<const i18n::Language> language;
+				try {
+					language = self->_languages.prepare(name);
+				}
+				catch (...) {
+					// 加载失败的异常交回界面线程抛出。
+					self->postEvent(std::make_shared<LambdaEvent>([error = std::current_exception()](Event*) {
+						std::rethrow_exception(error);
+						}));
+					return;
+				}
+				if (!language) return;
+				std::vector<std::string> values;
+				values.reserve(copies.size());
+				for (const auto& text : copies) values.push_back(text.localize(*language));
+				self->postEvent(std::make_shared<LambdaEvent>(
+					[self, name, serial, language, texts = std::move(texts),
+					copies = std::move(copies), values = std::move(values)](Event*) mutable {
+					if (serial != self->_switch_serial) return;
+					self->_languages.current(name);
+					// 期间语言被重新加载过，预本地化的结果不可靠，交给渲染时重新本地化。
+					const bool fresh = self->_languages.current() == language;
+					if (!fresh) return;
+					// 只处理仍然存在的文字；prime 会再确认内容没有被替换。
+					std::vector<const i18n::Text*> live;
+					for (auto* widget : self->_widgets) widget->collectTexts(live);
+					const std::unordered_set<const i18n::Text*> alive(live.begin(), live.end());
+					for (size_t i = 0; i < texts.size(); i++) {
+						if (alive.count(texts[i])) {
+							texts[i]->prime(copies[i], std::move(values[i]), self->_languages.generation());
+						}
+					}
+					}));
+				}));
+			}));
 	}
 
 }
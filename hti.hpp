@@ -5,57 +5,277 @@
 // 一个轻量级的 TUI（文本用户界面）库
 namespace hti {
 
-    // 国际化（不自带多线程支持）
+    // 国际化
+    // LanguageManager 可以在任意线程读取；Text 的缓存只能在主线程使用。
     namespace i18n {
 
+        // 消息 ID
+        // 键名在全局登记为从 0 开始的连续整数，语言按 ID 直接索引。
+        typedef uint32_t MessageId;
+
+        // 登记键名并返回它的 ID
+        // 同一个键名总是得到同一个 ID。线程安全。
+        MessageId intern(std::string_view key);
+
+        // 查找已登记的键名
+        // 找不到返回 false，不会登记新的键名。线程安全，不加锁。
+        bool lookup(std::string_view key, MessageId& id);
+
+        // 格式化参数
+        // 只保存视图，不分配内存。
+        struct Arg {
+            std::string_view name;
+            std::variant<int64_t, double, std::string_view> value;
+            template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+            Arg(std::string_view name, T value) : name(name), value(int64_t(value)) {}
+            Arg(std::string_view name, double value);
+            Arg(std::string_view name, std::string_view value);
+            Arg(std::string_view name, const char* value);
+            Arg(std::string_view name, const std::string& value);
+        };
+
+        // 编译好的消息模板
+        // 支持 {name}、{name, plural, =0 {...} one {# ...} other {# ...}} 与
+        // {name, select, a {...} other {...}}。复数规则只区分 =N、one（等于 1）和 other。
+        // 和 ICU 一样用单引号转义：'' 是一个单引号，'{'、'}' 与复数里的 '#' 原样输出。
+        // 模板中的文字是 pattern 的视图，pattern 必须比模板活得久。
+        class MessageFormat {
+            struct Node {
+                enum Kind { LITERAL, ARGUMENT, POUND, PLURAL, SELECT } kind;
+                std::string_view text;
+                uint32_t first;
+                uint32_t count;
+            };
+            struct Case {
+                std::string_view key;
+                uint32_t first;
+                uint32_t count;
+            };
+            std::vector<Node> _nodes;
+            std::vector<Case> _cases;
+            uint32_t _first = 0;
+            uint32_t _count = 0;
+            // 解析一段消息，返回节点范围
+            void parse(std::string_view pattern, size_t& pos, int depth, bool nested, bool plural, uint32_t& first, uint32_t& count);
+            // 处理 pos 处的单引号
+            static void quote(std::string_view pattern, size_t& pos, bool plural, std::vector<Node>& nodes, size_t& literal);
+            void run(std::string& output, uint32_t first, uint32_t count, const Arg* args, size_t size, const Arg* pound) const;
+        public:
+            // 解析模板
+            // 格式错误时抛出 std::runtime_error。
+            MessageFormat(std::string_view pattern);
+            // 判断字符串是否需要编译为模板
+            // 只有含 { 的字符串才会编译，其余的单引号不做转义。
+            static bool needed(std::string_view pattern);
+            // 格式化并追加到 output
+            // output 的容量会被复用，稳定状态下不分配内存。缺少的参数原样输出 {name}。
+            void format(std::string& output, const Arg* args, size_t size) const;
+            // 格式化并追加到 output
+            void format(std::string& output, std::initializer_list<Arg> args) const;
+        };
+
         // 语言
         class Language {
-            std::map<std::string, std::string> _content;
+            // 译文所在的内存（拼接的字符串或映射的文件），复制 Language 时共享。
+            std::shared_ptr<const void> _storage;
+            // 按消息 ID 索引的译文，没有译文的 data() 为 nullptr。
+            std::vector<std::string_view> _table;
+            // 按消息 ID 索引的模板，和 _table 一样长
+            // 第一次用到时编译，之前为 nullptr。用 std::atomic_load 等原子操作访问。
+            mutable std::vector<std::shared_ptr<const MessageFormat>> _formats;
         public:
             Language();
             // 从 JSON 字符串中加载语言。
-            Language(const std::string& content);
+            // 译文会被复制，content 用完即可释放，可以是映射的文件。
+            Language(std::string_view content);
+            // 将 JSON 字符串编译为二进制语言包
+            // 格式：头部（"HTIL"、版本、条目数、字符串区大小，均为 uint32），
+            // 按键名排序的条目（键偏移、键长度、值偏移、值长度），然后是字符串区。
+            static std::string compile(std::string_view content);
+            // 从二进制语言包加载语言
+            // 不复制译文，直接引用 data；owner 负责让 data 保持有效。
+            // 键名第一次出现时复制一份登记为消息 ID，之后再加载只做无锁查找。
+            static Language fromCatalog(std::string_view data, std::shared_ptr<const void> owner);
+            // 按顺序合并多个语言，前面的优先
+            // 用于回退链，合并后查找仍然是单次数组访问。合并结果引用原来的语言，不复制译文。
+            static Language flatten(const std::vector<std::shared_ptr<const Language>>& chain);
+            // 按消息 ID 查找译文
+            // 单次数组访问。
+            std::optional<std::string_view> find(MessageId id) const;
+            // 获取译文表的大小
+            // 所有有译文的消息 ID 都小于它。
+            size_t size() const;
+            // 按消息 ID 查找模板
+            // 译文不是模板时返回 nullptr。模板在第一次查找时编译，线程安全。
+            const MessageFormat* format(MessageId id) const;
             // 从键名本地化
             // 如果键名不存在，直接返回键值。
             std::string localize(const std::string& key) const;
         };
 
+        // 语言来源
+        // 在第一次切换到该语言时调用，返回加载好的语言。
+        typedef std::function<Language()> LanguageSource;
+
         // 管理所有的语言
+        // 读取方通过原子操作拿到不可变的快照，不需要加锁；加载和切换会发布新的快照。
         class LanguageManager {
-            std::map<std::string, Language> _languages;
-            std::string _current;
+        public:
+            // 某一时刻的所有语言
+            // 发布后不再修改，可以在任意线程持有。
+            struct Snapshot {
+                // 已加载的语言，没有合并回退链
+                std::map<std::string, std::shared_ptr<const Language>> languages;
+                std::string current_name;
+                // 当前语言，已合并回退链
+                std::shared_ptr<const Language> current;
+                uint64_t generation;
+                // 切换当前语言时的代数，此前的缓存全部过期
+                uint64_t switched;
+                // 当前语言重新加载后译文有变化的消息，以及变化时的代数
+                // 切换语言时清空。
+                std::shared_ptr<const std::unordered_map<MessageId, uint64_t>> changed;
+                // 判断某个消息在指定代数之后是否变化过
+                bool changedSince(MessageId id, uint64_t generation) const;
+            };
+        private:
+            std::shared_ptr<const Snapshot> _snapshot;
+            // 与快照中的代数相同，单独存放以便无锁读取。
+            std::atomic<uint64_t> _generation;
+            // 写入方互斥，同时保护 _sources、_sources_version、_fallbacks 与 _flattened。
+            std::mutex _mtx;
+            std::map<std::string, LanguageSource> _sources;
+            // 每次登记来源时增加，用于发现解锁加载期间来源被替换。
+            uint64_t _sources_version = 0;
+            std::map<std::string, std::vector<std::string>> _fallbacks;
+            // 合并过的回退链，链上的语言都没变时直接复用。
+            std::map<std::string, std::pair<std::vector<std::shared_ptr<const Language>>, std::shared_ptr<const Language>>> _flattened;
+            // 展开回退链，第一个是语言本身
+            // 调用方必须持有 _mtx。
+            std::vector<std::string> chainLocked(const std::string& name) const;
+            // 判断语言是否在当前语言的回退链上
+            // 调用方必须持有 _mtx。
+            bool activeLocked(const std::string& name) const;
+            // 合并已加载的回退链
+            // 调用方必须持有 _mtx。语言没有加载时返回 nullptr。
+            std::shared_ptr<const Language> resolveLocked(const std::string& name, const Snapshot& snapshot);
+            // 复制当前快照，修改后发布
+            // 调用方必须持有 _mtx。
+            void publish(const std::function<void(Snapshot&)>& change);
+            // 加载语言和回退链上还没有加载但登记过来源的语言
+            // 调用方必须通过 lock 持有 _mtx。调用来源时会暂时解锁，返回时重新持有。
+            void loadLocked(const std::string& name, std::unique_lock<std::mutex>& lock);
         public:
             // 默认初始化一个叫做 default 的语言。
             LanguageManager();
+            LanguageManager(const LanguageManager&) = delete;
+            LanguageManager& operator=(const LanguageManager&) = delete;
             // 从 JSON 字符串中加载语言
-            void load(const std::string& name, const std::string& content);
+            // 解析在调用方线程进行，不持有锁。
+            void load(const std::string& name, std::string_view content);
+            // 加载已经构造好的语言
+            void load(const std::string& name, Language language);
+            // 登记语言来源
+            // 不会立即加载，第一次切换到该语言时才加载。已加载的非当前语言会被卸载。
+            void source(const std::string& name, LanguageSource source);
+            // 设置回退链
+            // 缺少的译文依次在 fallbacks 中查找，回退语言自己的回退链也会展开。合并在加载时完成，查找不受影响。
+            void fallback(const std::string& name, std::vector<std::string> fallbacks);
+            // 卸载语言
+            // 只卸载登记过来源、不在当前语言回退链上的语言，之后切换到它时会重新加载。返回是否卸载。
+            bool unload(const std::string& name);
+            // 卸载所有登记过来源、不在当前语言回退链上的语言
+            void unloadInactive();
+            // 获取当前快照
+            // 线程安全。
+            std::shared_ptr<const Snapshot> snapshot() const;
             // 从键名本地化
-            // 如果键名不存在，直接返回键值。
+            // 如果键名不存在，直接返回键值。线程安全。
             std::string localize(std::string key) const;
             // 获取当前选中的语言
+            // 线程安全。
             std::string current_name() const;
             // 获取当前选中的语言
-            const Language* current() const;
+            // 线程安全。返回的语言在持有期间不会被释放。
+            std::shared_ptr<const Language> current() const;
             // 切换语言
+            // 如果语言还没有加载但登记过来源，先在调用方线程加载，加载时不持有锁。
             void current(std::string name);
+            // 获取语言，不切换
+            // 如果语言还没有加载但登记过来源，先在调用方线程加载，加载时不持有锁。
+            // 返回合并回退链后的语言，找不到返回 nullptr。
+            std::shared_ptr<const Language> prepare(const std::string& name);
+            // 获取代数
+            // 当前语言变化（切换或重新加载）时增加，用于判断本地化缓存是否过期。线程安全且无锁。
+            // 代数变化后可以用快照的 changedSince 判断具体的消息是否需要重新本地化。
+            uint64_t generation() const;
         };
 
         // 本地化单个键名
         // 请使用 Text 将多个 LocalizingString 与 std::string 拼接。
         class LocalizingString {
             std::string _key;
+            MessageId _id;
         public:
             // 从键名初始化
+            // 同时登记消息 ID。
             LocalizingString(std::string key);
+            // 获取键名
+            const std::string& key() const;
+            // 获取消息 ID
+            MessageId id() const;
             // 本地化
+            // 线程安全。返回副本，因为当前语言随时可能被替换。
             std::string localize(const LanguageManager& languages) const;
+            // 用指定的语言本地化
+            // 返回的视图在 language 销毁前有效，调用者负责持有它（比如快照）。
+            std::string_view localize(const Language& language) const;
+        };
+
+        // 带参数的消息
+        // 只在参数或语言变化时重新格式化，结果缓存在自身，稳定状态下不分配内存。
+        class Message {
+            LocalizingString _key;
+            std::vector<std::pair<std::string, std::variant<int64_t, double, std::string>>> _values;
+            mutable std::vector<Arg> _args;
+            mutable std::string _cache;
+            mutable uint64_t _cache_generation = 0;
+            // 设置参数，值变化时使缓存失效
+            template <typename T>
+            Message& assign(std::string_view name, T value) {
+                for (auto& [n, v] : this->_values) {
+                    if (n != name) continue;
+                    if (!std::holds_alternative<T>(v) || std::get<T>(v) != value) {
+                        v = std::move(value);
+                        this->_cache_generation = 0;
+                    }
+                    return *this;
+                }
+                this->_values.emplace_back(std::string(name), std::move(value));
+                this->_cache_generation = 0;
+                return *this;
+            }
+        public:
+            Message(const LocalizingString& key);
+            // 设置整数参数
+            template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+            Message& set(std::string_view name, T value) { return this->assign(name, int64_t(value)); }
+            // 设置浮点数参数
+            Message& set(std::string_view name, double value);
+            // 设置字符串参数
+            Message& set(std::string_view name, std::string_view value);
+            // 本地化
+            // 译文是模板时用参数格式化，否则同 LocalizingString。
+            const std::string& localize(const LanguageManager& languages) const;
         };
 
         // 将多个 LocalizingString 与 std::string 拼接
         class Text {
-            std::vector<std::variant<LocalizingString, std::string>> _parts;
+            typedef std::vector<std::variant<LocalizingString, std::string>> Parts;
+            // 拼接的部分不可变，复制 Text 时共享。
+            std::shared_ptr<const Parts> _parts;
             mutable std::string _cache;
-            mutable const Language* _cache_language;
+            mutable uint64_t _cache_generation = 0;
         public:
             Text();
             Text(const Text& text);
@@ -70,7 +290,14 @@ namespace hti {
             Text& operator+=(const Text& that);
             // 从键名本地化
             // 如果键名不存在，直接返回键值。
-            std::string localize(const LanguageManager& languages) const;
+            // 结果会缓存，直到语言切换或用到的译文重新加载后变化；返回的引用在下一次本地化或修改前有效。
+            const std::string& localize(const LanguageManager& languages) const;
+            // 用指定的语言本地化，不使用缓存
+            // 拼接的部分不可变，所以可以在工作线程对副本调用。
+            std::string localize(const Language& language) const;
+            // 预先填入缓存
+            // 仅当 source 与自身共享同一组拼接部分时生效，返回是否生效。用于后台预本地化。
+            bool prime(const Text& source, std::string value, uint64_t generation) const;
             // 获取拼接数量
             size_t size() const;
         };
@@ -120,6 +347,102 @@ namespace hti {
         void execute() override;
     };
 
+    // 可观察的值（抽象类）
+    // 写入方直接存储并请求重新渲染，绑定的控件在渲染时读取最新值，不经过事件队列。
+    class ObservableBase {
+        std::atomic<Application*> _app;
+    protected:
+        // 请求绑定的应用重新渲染
+        void notify();
+    public:
+        ObservableBase();
+        ObservableBase(const ObservableBase&) = delete;
+        ObservableBase& operator=(const ObservableBase&) = delete;
+        virtual ~ObservableBase();
+        // 绑定到应用
+        // 控件绑定时会自动调用。
+        void attach(Application* app);
+        // 转换为显示用的字符串
+        // 在主线程运行。
+        virtual std::string toString() const = 0;
+    };
+
+    // 可观察的标量
+    // 基于 std::atomic，读写都不分配内存。
+    template <typename T>
+    class Observable : public ObservableBase {
+        static_assert(std::is_trivially_copyable<T>::value,
+            "T must be trivially copyable");
+        std::atomic<T> _value;
+    public:
+        Observable(T value = T()) : _value(value) {}
+        // 存储新值
+        // 线程安全。
+        void store(T value) {
+            this->_value.store(value, std::memory_order_release);
+            this->notify();
+        }
+        // 读取最新值
+        // 线程安全。
+        T load() const {
+            return this->_value.load(std::memory_order_acquire);
+        }
+        std::string toString() const override {
+            std::ostringstream oss;
+            if constexpr (std::is_arithmetic<T>::value) oss << this->load();
+            return oss.str();
+        }
+    };
+
+    // 可观察的字符串
+    // 写入时发布一个新的不可变副本（RCU），读取方拿到的副本不会被改动。
+    template <>
+    class Observable<std::string> : public ObservableBase {
+        std::shared_ptr<const std::string> _value;
+    public:
+        Observable(std::string value = "");
+        // 存储新值
+        // 线程安全。
+        void store(std::string value);
+        // 读取最新值
+        // 线程安全。
+        std::shared_ptr<const std::string> load() const;
+        std::string toString() const override;
+    };
+
+    // 固定容量的数值环
+    // 任意线程都可以 push，不分配内存；控件渲染时读取最近的样本。
+    class SampleRing : public ObservableBase {
+        // 每个槽位记下所存样本的序号加一，写入期间为 0。
+        struct Slot {
+            std::atomic<size_t> sequence;
+            std::atomic<double> value;
+        };
+        std::unique_ptr<Slot[]> _samples;
+        size_t _capacity;
+        // 已分配的序号和已写完的最新样本的序号加一。
+        std::atomic<size_t> _claimed;
+        std::atomic<size_t> _count;
+    public:
+        SampleRing(size_t capacity = 128);
+        // 写入一个样本
+        // 线程安全。
+        void push(double value);
+        // 获取容量
+        size_t capacity() const;
+        // 获取当前保存的样本数
+        size_t size() const;
+        // 获取发布过的样本总数，也就是下一个样本的序号
+        size_t count() const;
+        // 按序号读取样本
+        // 已经移出环、还没发布或者还没写完（多个线程同时写入时）返回 NaN。
+        double at(size_t index) const;
+        // 读取最近的样本，age 为 0 是最新的
+        // 超出范围或者该样本还没写完返回 NaN。
+        double back(size_t age = 0) const;
+        std::string toString() const override;
+    };
+
     // 控件
     namespace widgets {
 
@@ -197,6 +520,9 @@ namespace hti {
             virtual void onFocusGained();
             // 当焦点没了
             virtual void onFocusLost();
+            // 收集需要本地化的文字
+            // 切换语言时用于后台预本地化。在主线程运行。
+            virtual void collectTexts(std::vector<const i18n::Text*>& texts) const;
         };
 
         // 可被选中的（抽象类）
@@ -219,17 +545,27 @@ namespace hti {
         public:
             virtual ~TextWidget();
             // 返回文字
-            i18n::Text text() const;
+            // 注意，如果不是主线程则结果不可靠。
+            const i18n::Text& text() const;
             // 设置文字
             void text(i18n::Text text);
+            // 返回本地化后的文字
+            // 使用自身保存的 Text 的缓存，只在文字或语言变化时重新本地化。在主线程运行。
+            const std::string& localized() const;
+            // 收集需要本地化的文字
+            void collectTexts(std::vector<const i18n::Text*>& texts) const override;
         };
 
         // 文本
         class Label : public TextWidget {
             friend class Widget;
         protected:
+            std::shared_ptr<ObservableBase> _value;
             Label(Widget* parent, i18n::Text text = {});
         public:
+            // 绑定一个可观察的值
+            // 渲染时显示在文字后面。传入 nullptr 解除绑定。
+            void bind(std::shared_ptr<ObservableBase> value);
             // 返回渲染内容
             std::string onRender(bool focus) override;
         };
@@ -339,6 +675,191 @@ namespace hti {
             std::string onRender(bool focus) override;
             // 处理按键
             bool onKeyPress(Key key) override;
+            // 收集需要本地化的文字
+            // 包括标题和导航栏。
+            void collectTexts(std::vector<const i18n::Text*>& texts) const override;
+        };
+
+        // 表格数据源（抽象类）
+        // Table 只按需读取可见的单元格，不会复制数据。
+        class TableSource {
+        public:
+            virtual ~TableSource();
+            // 行数
+            virtual size_t rows() const = 0;
+            // 列数
+            virtual size_t columns() const = 0;
+            // 列标题
+            // 默认返回空字符串。
+            virtual std::string header(size_t column) const;
+            // 单元格内容
+            virtual std::string cell(size_t row, size_t column) const = 0;
+            // 比较同一列中的两个单元格，用于排序
+            // 默认比较 cell() 的结果，子类可以覆写以避免构造字符串。
+            virtual int compare(size_t a, size_t b, size_t column) const;
+        };
+
+        // 按列存储的表格数据源
+        class ColumnTableSource : public TableSource {
+            std::vector<std::string> _headers;
+            std::vector<std::vector<std::string>> _columns;
+        public:
+            // 每一列的长度必须相同。
+            ColumnTableSource(std::vector<std::string> headers, std::vector<std::vector<std::string>> columns);
+            size_t rows() const override;
+            size_t columns() const override;
+            std::string header(size_t column) const override;
+            std::string cell(size_t row, size_t column) const override;
+            int compare(size_t a, size_t b, size_t column) const override;
+        };
+
+        // 表格
+        // 只渲染可见的行和列；排序只保存行号的排列，不复制行。
+        class Table : public SelectableWidget {
+            // 数据源在主线程替换，sort 会在其他线程读取，所以一律用 std::atomic_load 与 std::atomic_store 访问。
+            std::shared_ptr<const TableSource> _source;
+            // 排序后的行号，为空表示按数据源的顺序。
+            std::vector<uint32_t> _order;
+            // 列宽，由抽样计算，为空表示需要重新计算。
+            std::vector<size_t> _widths;
+            size_t _rows;
+            size_t _width;
+            size_t _top = 0;
+            size_t _cursor = 0;
+            size_t _left = 0;
+            friend class Widget;
+            // 显示顺序中第 index 行对应的数据源行号
+            size_t row(size_t index) const;
+            // 抽样计算列宽
+            // 宽度按终端列数计算。
+            void measure(const TableSource& source);
+        protected:
+            Table(Widget* parent, std::shared_ptr<const TableSource> source = nullptr, size_t rows = 20, size_t width = 80);
+        public:
+            // 抽样计算列宽时最多读取的行数。
+            static constexpr size_t SAMPLE_ROWS = 256;
+            // 单列的最大宽度。
+            static constexpr size_t MAX_COLUMN_WIDTH = 32;
+            // 设置数据源
+            // 会清除排序。
+            void source(std::shared_ptr<const TableSource> source);
+            // 按某一列排序
+            // 排列在调用方线程计算，完成后再交给主线程。
+            void sort(size_t column, bool ascending = true);
+            // 恢复数据源的顺序
+            void unsort();
+            // 获取当前选中的行（数据源中的行号）
+            // 注意，如果不是主线程则结果不可靠。
+            size_t selected() const;
+            // 返回渲染内容
+            std::string onRender(bool focus) override;
+            // 处理按键
+            bool onKeyPress(Key key) override;
+        };
+
+        // 进度条
+        // 绑定一个 0 到 1 之间的可观察值，渲染时读取最新值。
+        class ProgressBar : public Widget {
+            std::shared_ptr<Observable<double>> _value;
+            size_t _width;
+            friend class Widget;
+        protected:
+            ProgressBar(Widget* parent, std::shared_ptr<Observable<double>> value = nullptr, size_t width = 20);
+        public:
+            // 绑定进度
+            void bind(std::shared_ptr<Observable<double>> value);
+            // 用方块字符画一条横条，精确到 1/8 格
+            static void bar(std::string& output, double ratio, size_t width);
+            // 返回渲染内容
+            std::string onRender(bool focus) override;
+        };
+
+        // 仪表
+        // 显示数值环中的最新值、横条和窗口内的峰值。
+        class Gauge : public Widget {
+            std::shared_ptr<SampleRing> _samples;
+            double _min;
+            double _max;
+            size_t _width;
+            // 增量维护的最新值和峰值，每帧只看新发布的样本。
+            double _value = 0.0;
+            double _peak;
+            size_t _peak_index = 0;
+            size_t _seen = 0;
+            // 读取新发布的样本，更新最新值和峰值
+            void update();
+            friend class Widget;
+        protected:
+            Gauge(Widget* parent, std::shared_ptr<SampleRing> samples = nullptr, double min = 0.0, double max = 100.0, size_t width = 20);
+        public:
+            // 绑定数值环
+            void bind(std::shared_ptr<SampleRing> samples);
+            // 返回渲染内容
+            std::string onRender(bool focus) override;
+        };
+
+        // 迷你折线图
+        // 每一列对应数值环中的一个样本（盲文样式是两个），渲染为 O(width)。
+        class Sparkline : public Widget {
+            std::shared_ptr<SampleRing> _samples;
+            double _min;
+            double _max;
+            size_t _width;
+            Style _style;
+            friend class Widget;
+        protected:
+            // min 与 max 相等时按可见样本自动缩放。
+            Sparkline(Widget* parent, std::shared_ptr<SampleRing> samples = nullptr, size_t width = 32, double min = 0.0, double max = 0.0, Style style = STYLE_BLOCK);
+        public:
+            // 使用方块字符，每列一个样本。
+            const static int STYLE_BLOCK = 0x0;
+            // 使用盲文字符，每列两个样本。
+            const static int STYLE_BRAILLE = 0x1;
+            // 绑定数值环
+            void bind(std::shared_ptr<SampleRing> samples);
+            // 返回渲染内容
+            std::string onRender(bool focus) override;
+        };
+
+        // 日志视图
+        // 任意线程都可以直接 append，主线程只在渲染时取出新的行。
+        class LogView : public SelectableWidget {
+            chh::RingQueue<std::string> _queue;
+            std::atomic<bool> _pending;
+            std::atomic<size_t> _dropped;
+            std::deque<std::string> _lines;
+            size_t _bytes = 0;
+            size_t _evicted = 0;
+            size_t _limit;
+            size_t _rows;
+            // 视图底部距离最后一行的行数。
+            size_t _offset = 0;
+            bool _follow = true;
+            friend class Widget;
+            // 取出队列中的新行并按字节数限制裁剪
+            // 由 append 投递到主线程的事件调用，与是否渲染无关。
+            void drain();
+        protected:
+            // capacity 是等待渲染的行数上限，limit 是保留的历史字节数上限。
+            LogView(Widget* parent, size_t rows = 20, size_t capacity = 4096, size_t limit = 1 << 20);
+        public:
+            // 追加一行
+            // 线程安全，行本身不经过事件队列，一批行只投递一个事件。队列满时丢弃并返回 false。
+            // 行内不要包含换行。
+            bool append(std::string line);
+            // 因队列满而丢弃的行数
+            size_t dropped() const;
+            // 因超出历史字节数上限而移除的行数
+            // 注意，如果不是主线程则结果不可靠。
+            size_t evicted() const;
+            // 是否跟随最新的行
+            bool follow() const;
+            // 设置是否跟随最新的行
+            void follow(bool follow);
+            // 返回渲染内容
+            std::string onRender(bool focus) override;
+            // 处理按键
+            bool onKeyPress(Key key) override;
         };
 
     }
@@ -350,17 +871,31 @@ namespace hti {
         std::thread::id const _thrd_id;
         /* 控件功能 */
         bool _should_exit;
+        std::atomic<bool> _dirty;
         std::queue<std::shared_ptr<Event>> _events;
         std::list<widgets::Widget*> _widgets;
         std::list<Widget*>::iterator _focus;
+        // 上一帧每一行的内容和哈希，用于只输出变化的部分。
+        std::vector<std::string> _frame;
+        std::vector<size_t> _frame_hash;
+        int _frame_width = 0;
 #if CHH_IS_WINDOWS
         HANDLE _ihandle;
         HANDLE _ohandle;
 #endif
         /* 语言管理 */
         i18n::LanguageManager _languages;
+        // 放在 _languages 之后，先于它析构。
+        std::map<std::string, std::unique_ptr<chh::FileWatcher>> _language_watchers;
+        // 最近一次切换语言的序号，只有最新的切换会生效。
+        uint64_t _switch_serial = 0;
+        // 正在后台预本地化的任务。
+        std::list<std::future<void>> _switching;
         bool processEvent();
         void getConsoleSize(int& width, int& height);
+        // 将一帧输出到终端
+        // 与上一帧比较，能用滚动区域（DECSTBM + CSI S/T）的就滚动，然后只重画变化的行。
+        void present(std::vector<std::string>& lines, int width);
         friend class Widget;
     public:
         Application();
@@ -381,6 +916,9 @@ namespace hti {
         // 如果调用方是主线程，直接执行，不同于 postEvent。
         // 提高代码复用率。
         void tryPostEvent(std::shared_ptr<Event> event);
+        // 请求在下一次循环时重新渲染
+        // 线程安全，不经过事件队列。
+        void markDirty();
 
         /* 控件功能 */
         // 渲染
@@ -400,7 +938,39 @@ namespace hti {
         // 从 JSON 字符串加载语言
         void loadLanguage(const std::string& name, const std::string& content);
         // 从 JSON 文件加载语言
+        // 文件以只读方式映射后直接解析。解析期间文件不能被截断，否则访问映射的页会出错（Linux 上是 SIGBUS）；
+        // 可能被同时改写的文件请用 watchLanguageFile 或 registerLanguageFromFile，它们读取副本。
         void loadLanguageFromFile(const std::string& name, const std::string& file_name);
+        // 从二进制语言包文件加载语言
+        // 文件以只读方式映射，译文不会被复制。语言包由 i18n::Language::compile 生成。
+        void loadLanguageFromCatalog(const std::string& name, const std::string& file_name);
+        // 登记 JSON 字符串作为语言来源
+        // 第一次切换到该语言时才解析。
+        void registerLanguage(const std::string& name, const std::string& content);
+        // 登记 JSON 文件作为语言来源
+        // 第一次切换到该语言时才读取。读取的是副本，不怕文件在那时正被改写。
+        void registerLanguageFromFile(const std::string& name, const std::string& file_name);
+        // 登记二进制语言包文件作为语言来源
+        // 第一次切换到该语言时才映射。
+        void registerLanguageFromCatalog(const std::string& name, const std::string& file_name);
+        // 登记内存中的语言作为语言来源
+        // 用于嵌入程序的语言包，data 必须在程序运行期间有效。以 "HTIL" 开头的是二进制语言包，
+        // 直接引用 data，不复制；否则按 JSON 解析。
+        void registerLanguageFromMemory(const std::string& name, std::string_view data);
+        // 卸载语言
+        // 只卸载登记过来源、不在当前语言回退链上的语言。
+        bool unloadLanguage(const std::string& name);
+        // 卸载所有登记过来源、不在当前语言回退链上的语言
+        void unloadInactiveLanguages();
+        // 加载语言文件并监视变化
+        // 文件变化后在后台线程重新解析并原子地替换语言，界面线程不做解析；只有用到的译文变了的 Text 会重新本地化。
+        // 解析失败时保留原来的语言。
+        void watchLanguageFile(const std::string& name, const std::string& file_name);
+        // 停止监视语言文件
+        void unwatchLanguageFile(const std::string& name);
+        // 设置语言的回退链
+        // 例如 zh-TW 回退到 zh 再回退到 en，缺少的译文不再显示键名。
+        void fallbackLanguage(const std::string& name, std::vector<std::string> fallbacks);
 #if CHH_IS_WINDOWS
         // 从资源加载语言
         // 该函数仅在 Windows 平台上可用。
@@ -409,8 +979,13 @@ namespace hti {
         // 从资源加载语言
         // 该函数在 Linux 平台上不可用。
         void loadLanguageFromResource(const std::string& name, const size_t& res_name, const std::string& res_type) = delete;
+        // 从嵌入程序的资源加载语言
+        // 该函数仅在 Linux 平台上可用。资源用 CHH_RESOURCE 登记；二进制语言包直接引用程序映像，不复制。
+        void loadLanguageFromResource(const std::string& name, const std::string& res_name);
 #endif
         // 切换语言
+        // 先在工作线程加载语言（如果还没有加载）并预本地化所有控件的文字，完成后再在主线程切换，
+        // 因此切换会在之后的某一帧生效。
         void switchLanguage(const std::string& name);
     };
 
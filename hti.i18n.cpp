@@ -1,103 +1,591 @@
 ﻿#include "hti.hpp"
+#include <algorithm>
 
 namespace hti::i18n {
 
+    // 键名到 ID 的登记表。
+    // 登记新键名时加锁；查找不加锁，直接探测开放寻址的哈希表。
+    // 条目放在 deque 里，地址不会变化。槽位先写好条目再发布指针。
+    // 超过一半满时建一张两倍大的新表再换上去。旧表留着不释放，正在探测它的线程可以继续读。
+    // 用函数内的静态变量，避免静态初始化顺序的问题。
+    struct InternTable {
+        struct Entry {
+            std::string name;
+            MessageId id;
+        };
+        struct Index {
+            size_t mask;
+            std::unique_ptr<std::atomic<const Entry*>[]> slots;
+            Index(size_t capacity) : mask(capacity - 1), slots(new std::atomic<const Entry*>[capacity]) {
+                for (size_t i = 0; i < capacity; i++) this->slots[i].store(nullptr, std::memory_order_relaxed);
+            }
+        };
+        std::mutex mtx;
+        std::deque<Entry> entries;
+        std::deque<Index> indexes;
+        std::atomic<const Index*> index;
+        InternTable() : index(&this->indexes.emplace_back(64)) {}
+        static const Entry* find(const Index& index, std::string_view key) {
+            for (size_t i = std::hash<std::string_view>()(key) & index.mask;; i = (i + 1) & index.mask) {
+                const Entry* entry = index.slots[i].load(std::memory_order_acquire);
+                if (!entry || entry->name == key) return entry;
+            }
+        }
+        static void insert(const Index& index, const Entry* entry) {
+            size_t i = std::hash<std::string_view>()(entry->name) & index.mask;
+            while (index.slots[i].load(std::memory_order_relaxed)) i = (i + 1) & index.mask;
+            index.slots[i].store(entry, std::memory_order_release);
+        }
+    };
+
+    static InternTable& internTable() {
+        static InternTable table;
+        return table;
+    }
+
+    MessageId intern(std::string_view key) {
+        MessageId id;
+        if (lookup(key, id)) return id;
+        auto& table = internTable();
+        std::lock_guard<std::mutex> lock(table.mtx);
+        const InternTable::Index* index = table.index.load(std::memory_order_relaxed);
+        if (auto entry = InternTable::find(*index, key)) return entry->id;
+        if ((table.entries.size() + 1) * 2 > index->mask + 1) {
+            auto& grown = table.indexes.emplace_back((index->mask + 1) * 2);
+            for (const auto& i : table.entries) InternTable::insert(grown, &i);
+            table.index.store(&grown, std::memory_order_release);
+            index = &grown;
+        }
+        table.entries.push_back({ std::string(key), MessageId(table.entries.size()) });
+        InternTable::insert(*index, &table.entries.back());
+        return table.entries.back().id;
+    }
+
+    bool lookup(std::string_view key, MessageId& id) {
+        auto& table = internTable();
+        auto entry = InternTable::find(*table.index.load(std::memory_order_acquire), key);
+        if (!entry) return false;
+        id = entry->id;
+        return true;
+    }
+
+    // 读取语言 JSON 的处理器
+    // 只接受一层对象，键名和译文直接交给回调，不构建 Json::Value。
+    class LanguageReader : public Json::ParseHandler {
+        std::function<void(std::string_view, std::string_view)> _entry;
+        // 键名的视图只在回调期间有效，所以复制一份。
+        std::string _key;
+        int _depth = 0;
+        bool value(std::string_view value) {
+            if (this->_depth == 0) throw std::runtime_error("`root` is not an object.");
+            this->_entry(this->_key, value);
+            return true;
+        }
+        bool nested() {
+            if (this->_depth == 0) {
+                throw std::runtime_error("`root` is not an object.");
+            }
+            throw std::runtime_error("`" + this->_key + "` is not a string.");
+        }
+    public:
+        LanguageReader(std::function<void(std::string_view, std::string_view)> entry) : _entry(entry) {}
+        bool onNull() override { return this->value(""); }
+        bool onBool(bool value) override { return this->value(value ? "true" : "false"); }
+        bool onInt(Json::LargestInt value) override { return this->value(Json::valueToString(value)); }
+        bool onUInt(Json::LargestUInt value) override { return this->value(Json::valueToString(value)); }
+        bool onDouble(double value) override { return this->value(Json::valueToString(value)); }
+        bool onString(const char* begin, const char* end) override {
+            return this->value(std::string_view(begin, end - begin));
+        }
+        bool onKey(const char* begin, const char* end) override {
+            this->_key.assign(begin, end);
+            return true;
+        }
+        bool onObjectBegin() override {
+            if (this->_depth != 0) return this->nested();
+            this->_depth++;
+            return true;
+        }
+        bool onArrayBegin() override { return this->nested(); }
+    };
+
     Language::Language() = default;
 
-    Language::Language(const std::string& content) {
-        Json::Value root = chh::parseJson(content);
-        if (!root.isObject()) {
-            throw std::runtime_error("`root` is not an object.");
+    Language::Language(std::string_view content) {
+        // 先拼接所有译文，再建立视图，避免拼接时重新分配导致视图失效。
+        auto storage = std::make_shared<std::string>();
+        std::vector<std::pair<MessageId, std::pair<size_t, size_t>>> entries;
+        LanguageReader reader([&](std::string_view key, std::string_view value) {
+            entries.push_back({ intern(key), { storage->size(), value.size() } });
+            storage->append(value);
+            });
+        chh::parseJson(content, reader);
+        this->_storage = storage;
+        MessageId size = 0;
+        for (const auto& i : entries) size = std::max(size, i.first + 1);
+        this->_table.resize(size);
+        this->_formats.resize(size);
+        for (const auto& [id, range] : entries) {
+            this->_table[id] = std::string_view(storage->data() + range.first, range.second);
+        }
+    }
+
+    // 二进制语言包的头部和条目，均按本机字节序存放。
+    struct CatalogHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t count;
+        uint32_t blob_size;
+    };
+
+    struct CatalogEntry {
+        uint32_t key_offset;
+        uint32_t key_size;
+        uint32_t value_offset;
+        uint32_t value_size;
+    };
+
+    std::string Language::compile(std::string_view content) {
+        // map 按键名排序，重复的键名以最后一个为准。
+        std::map<std::string, std::string> members;
+        LanguageReader reader([&](std::string_view key, std::string_view value) {
+            members[std::string(key)] = std::string(value);
+            });
+        chh::parseJson(content, reader);
+        std::string blob;
+        std::vector<CatalogEntry> entries;
+        for (const auto& [i, value] : members) {
+            CatalogEntry entry;
+            entry.key_offset = uint32_t(blob.size());
+            entry.key_size = uint32_t(i.size());
+            blob += i;
+            entry.value_offset = uint32_t(blob.size());
+            entry.value_size = uint32_t(value.size());
+            blob += value;
+            entries.push_back(entry);
+        }
+        if (blob.size() > std::numeric_limits<uint32_t>::max()) {
+            throw std::runtime_error("Language is too large to compile.");
+        }
+        CatalogHeader header = { { 'H', 'T', 'I', 'L' }, 1, uint32_t(entries.size()), uint32_t(blob.size()) };
+        std::string result;
+        result.append((const char*)&header, sizeof(header));
+        result.append((const char*)entries.data(), entries.size() * sizeof(CatalogEntry));
+        result += blob;
+        return result;
+    }
+
+    Language Language::fromCatalog(std::string_view data, std::shared_ptr<const void> owner) {
+        CatalogHeader header;
+        if (data.size() < sizeof(header)) {
+            throw std::runtime_error("Catalog is truncated.");
+        }
+        memcpy(&header, data.data(), sizeof(header));
+        if (memcmp(header.magic, "HTIL", 4) != 0 || header.version != 1) {
+            throw std::runtime_error("Catalog has an unknown format.");
+        }
+        const size_t entries_size = size_t(header.count) * sizeof(CatalogEntry);
+        if (data.size() != sizeof(header) + entries_size + header.blob_size) {
+            throw std::runtime_error("Catalog is truncated.");
+        }
+        const char* entries = data.data() + sizeof(header);
+        const char* blob = entries + entries_size;
+        // 先检查条目并取得所有 ID，译文表只分配一次。
+        // 已登记的键名只做无锁查找；没见过的键名复制一份登记，每个进程只有一次。
+        std::vector<MessageId> ids(header.count);
+        MessageId size = 0;
+        for (uint32_t i = 0; i < header.count; i++) {
+            CatalogEntry entry;
+            memcpy(&entry, entries + i * sizeof(CatalogEntry), sizeof(entry));
+            if (uint64_t(entry.key_offset) + entry.key_size > header.blob_size ||
+                uint64_t(entry.value_offset) + entry.value_size > header.blob_size) {
+                throw std::runtime_error("Catalog entry is out of range.");
+            }
+            ids[i] = intern(std::string_view(blob + entry.key_offset, entry.key_size));
+            size = std::max(size, ids[i] + 1);
         }
-        for (const auto& i : root.getMemberNames()) {
-            this->_content[i] = root[i].asString();
+        Language language;
+        language._storage = owner;
+        language._table.resize(size);
+        language._formats.resize(size);
+        for (uint32_t i = 0; i < header.count; i++) {
+            CatalogEntry entry;
+            memcpy(&entry, entries + i * sizeof(CatalogEntry), sizeof(entry));
+            language._table[ids[i]] = std::string_view(blob + entry.value_offset, entry.value_size);
+        }
+        return language;
+    }
+
+    Language Language::flatten(const std::vector<std::shared_ptr<const Language>>& chain) {
+        Language language;
+        // 持有链上的语言，它们的译文和模板因此保持有效。
+        language._storage = std::make_shared<const std::vector<std::shared_ptr<const Language>>>(chain);
+        size_t size = 0;
+        for (const auto& i : chain) size = std::max(size, i->_table.size());
+        language._table.resize(size);
+        language._formats.resize(size);
+        // 从后往前覆盖，前面的语言优先。已经编译的模板直接共享，其余的用到时再编译。
+        for (auto i = chain.rbegin(); i != chain.rend(); i++) {
+            const Language& source = **i;
+            for (size_t id = 0; id < source._table.size(); id++) {
+                if (!source._table[id].data()) continue;
+                language._table[id] = source._table[id];
+                language._formats[id] = std::atomic_load(&source._formats[id]);
+            }
+        }
+        return language;
+    }
+
+    // 译文不是模板或者解析不了时存放的标记，和还没编译的 nullptr 区分开。
+    static const std::shared_ptr<const MessageFormat>& literalFormat() {
+        static const auto literal = std::make_shared<const MessageFormat>("");
+        return literal;
+    }
+
+    const MessageFormat* Language::format(MessageId id) const {
+        if (id >= this->_formats.size()) return nullptr;
+        auto format = std::atomic_load(&this->_formats[id]);
+        if (!format) {
+            format = literalFormat();
+            if (this->_table[id].data() && MessageFormat::needed(this->_table[id])) {
+                try {
+                    format = std::make_shared<const MessageFormat>(this->_table[id]);
+                }
+                catch (const std::runtime_error&) {
+                    // 解析不了的译文（比如只是带了个花括号）按普通文字处理，不影响整个语言。
+                }
+            }
+            // 其他线程可能同时编译了同一个模板，以先写入的为准。
+            std::shared_ptr<const MessageFormat> expected;
+            if (!std::atomic_compare_exchange_strong(&this->_formats[id], &expected, format)) format = expected;
         }
+        return format == literalFormat() ? nullptr : format.get();
+    }
+
+    std::optional<std::string_view> Language::find(MessageId id) const {
+        if (id < this->_table.size() && this->_table[id].data()) return this->_table[id];
+        return std::nullopt;
+    }
+
+    size_t Language::size() const {
+        return this->_table.size();
     }
 
     std::string Language::localize(const std::string& key) const {
-        if (this->_content.count(key)) {
-            return this->_content.at(key);
+        MessageId id;
+        if (lookup(key, id)) {
+            if (auto value = this->find(id)) return std::string(*value);
         }
-        else {
-            return key;
+        return key;
+    }
+
+    LanguageManager::LanguageManager() : _generation(1) {
+        auto snapshot = std::make_shared<Snapshot>();
+        snapshot->current = std::make_shared<const Language>(Language("{}"));
+        snapshot->current_name = "default";
+        snapshot->languages["default"] = snapshot->current;
+        snapshot->generation = 1;
+        snapshot->switched = 1;
+        snapshot->changed = std::make_shared<const std::unordered_map<MessageId, uint64_t>>();
+        this->_snapshot = snapshot;
+    }
+
+    bool LanguageManager::Snapshot::changedSince(MessageId id, uint64_t generation) const {
+        if (generation < this->switched) return true;
+        auto it = this->changed->find(id);
+        return it != this->changed->end() && it->second > generation;
+    }
+
+    std::vector<std::string> LanguageManager::chainLocked(const std::string& name) const {
+        std::vector<std::string> chain = { name };
+        // 逐个展开回退语言自己的回退链，跳过重复的，避免循环。
+        for (size_t i = 0; i < chain.size(); i++) {
+            auto it = this->_fallbacks.find(chain[i]);
+            if (it == this->_fallbacks.end()) continue;
+            for (const auto& j : it->second) {
+                if (std::find(chain.begin(), chain.end(), j) == chain.end()) chain.push_back(j);
+            }
         }
+        return chain;
     }
 
-    LanguageManager::LanguageManager() {
-        this->_languages["default"] = Language("{}");
-        this->current("default");
+    bool LanguageManager::activeLocked(const std::string& name) const {
+        const auto chain = this->chainLocked(this->_snapshot->current_name);
+        return std::find(chain.begin(), chain.end(), name) != chain.end();
     }
 
-    void LanguageManager::load(const std::string& name, const std::string& content) {
-        this->_languages[name] = Language(content);
+    std::shared_ptr<const Language> LanguageManager::resolveLocked(const std::string& name, const Snapshot& snapshot) {
+        auto it = snapshot.languages.find(name);
+        if (it == snapshot.languages.end()) return nullptr;
+        std::vector<std::shared_ptr<const Language>> chain;
+        for (const auto& i : this->chainLocked(name)) {
+            auto language = snapshot.languages.find(i);
+            if (language != snapshot.languages.end()) chain.push_back(language->second);
+        }
+        if (chain.size() == 1) {
+            this->_flattened.erase(name);
+            return it->second;
+        }
+        auto& cached = this->_flattened[name];
+        if (cached.first != chain) {
+            cached.second = std::make_shared<const Language>(Language::flatten(chain));
+            cached.first = std::move(chain);
+        }
+        return cached.second;
     }
 
-    void LanguageManager::current(std::string name) {
-        if (this->_languages.count(name)) {
-            this->_current = name;
+    void LanguageManager::publish(const std::function<void(Snapshot&)>& change) {
+        auto snapshot = std::make_shared<Snapshot>(*this->_snapshot);
+        change(*snapshot);
+        // 当前语言或它的回退链换了（包括重新加载）才增加代数。
+        auto current = this->resolveLocked(snapshot->current_name, *snapshot);
+        if (current && current != snapshot->current) {
+            snapshot->generation++;
+            if (snapshot->current_name != this->_snapshot->current_name) {
+                snapshot->switched = snapshot->generation;
+                snapshot->changed = std::make_shared<const std::unordered_map<MessageId, uint64_t>>();
+            }
+            else {
+                // 同一个语言重新加载，记下译文变化的消息，其他缓存可以继续使用。
+                auto changed = std::make_shared<std::unordered_map<MessageId, uint64_t>>(*snapshot->changed);
+                const Language& before = *snapshot->current;
+                const size_t size = std::max(before.size(), current->size());
+                for (MessageId id = 0; id < size; id++) {
+                    if (before.find(id) != current->find(id)) (*changed)[id] = snapshot->generation;
+                }
+                snapshot->changed = std::move(changed);
+            }
+            snapshot->current = current;
+        }
+        // 丢弃引用了已卸载语言的合并结果。
+        for (auto it = this->_flattened.begin(); it != this->_flattened.end();) {
+            bool stale = !snapshot->languages.count(it->first);
+            for (const auto& i : it->second.first) {
+                stale = stale || std::none_of(snapshot->languages.begin(), snapshot->languages.end(),
+                    [&](const auto& loaded) { return loaded.second == i; });
+            }
+            if (stale) it = this->_flattened.erase(it);
+            else it++;
+        }
+        this->_generation.store(snapshot->generation, std::memory_order_release);
+        std::atomic_store(&this->_snapshot, std::shared_ptr<const Snapshot>(std::move(snapshot)));
+    }
+
+    void LanguageManager::loadLocked(const std::string& name, std::unique_lock<std::mutex>& lock) {
+        while (true) {
+            std::map<std::string, LanguageSource> pending;
+            for (const auto& i : this->chainLocked(name)) {
+                if (this->_snapshot->languages.count(i)) continue;
+                auto source = this->_sources.find(i);
+                if (source != this->_sources.end()) pending[i] = source->second;
+            }
+            if (pending.empty()) return;
+            const uint64_t version = this->_sources_version;
+            // 读文件和解析不持有锁，其他写入方不用等待。
+            lock.unlock();
+            std::map<std::string, std::shared_ptr<const Language>> loaded;
+            for (const auto& [i, source] : pending) loaded[i] = std::make_shared<const Language>(source());
+            lock.lock();
+            // 期间来源被替换过，加载的可能是旧内容，重新加载。
+            if (version != this->_sources_version) continue;
+            this->publish([&](Snapshot& snapshot) {
+                // 期间被直接加载的语言以直接加载的为准。
+                for (const auto& [i, language] : loaded) snapshot.languages.emplace(i, language);
+                });
+            return;
         }
     }
 
+    void LanguageManager::load(const std::string& name, std::string_view content) {
+        this->load(name, Language(content));
+    }
+
+    void LanguageManager::load(const std::string& name, Language language) {
+        auto loaded = std::make_shared<const Language>(std::move(language));
+        std::lock_guard<std::mutex> lock(this->_mtx);
+        this->publish([&](Snapshot& snapshot) {
+            snapshot.languages[name] = loaded;
+            });
+    }
+
+    void LanguageManager::source(const std::string& name, LanguageSource source) {
+        std::lock_guard<std::mutex> lock(this->_mtx);
+        this->_sources[name] = source;
+        this->_sources_version++;
+        if (!this->activeLocked(name) && this->_snapshot->languages.count(name)) {
+            this->publish([&](Snapshot& snapshot) {
+                snapshot.languages.erase(name);
+                });
+        }
+    }
+
+    bool LanguageManager::unload(const std::string& name) {
+        std::lock_guard<std::mutex> lock(this->_mtx);
+        if (this->activeLocked(name) || !this->_sources.count(name) ||
+            !this->_snapshot->languages.count(name)) {
+            return false;
+        }
+        this->publish([&](Snapshot& snapshot) {
+            snapshot.languages.erase(name);
+            });
+        return true;
+    }
+
+    void LanguageManager::unloadInactive() {
+        std::lock_guard<std::mutex> lock(this->_mtx);
+        this->publish([&](Snapshot& snapshot) {
+            for (const auto& [name, source] : this->_sources) {
+                if (!this->activeLocked(name)) snapshot.languages.erase(name);
+            }
+            });
+    }
+
+    void LanguageManager::fallback(const std::string& name, std::vector<std::string> fallbacks) {
+        std::unique_lock<std::mutex> lock(this->_mtx);
+        this->_fallbacks[name] = std::move(fallbacks);
+        if (!this->activeLocked(name)) return;
+        // 当前语言的回退链变了，加载新加入的语言并重新合并。
+        // 加载时会解锁，快照可能被替换，先复制名字。
+        const std::string current = this->_snapshot->current_name;
+        this->loadLocked(current, lock);
+        this->publish([](Snapshot&) {});
+    }
+
+    void LanguageManager::current(std::string name) {
+        std::unique_lock<std::mutex> lock(this->_mtx);
+        if (name == this->_snapshot->current_name) return;
+        this->loadLocked(name, lock);
+        if (name == this->_snapshot->current_name || !this->resolveLocked(name, *this->_snapshot)) return;
+        this->publish([&](Snapshot& snapshot) {
+            snapshot.current_name = name;
+            });
+    }
+
+    std::shared_ptr<const Language> LanguageManager::prepare(const std::string& name) {
+        std::unique_lock<std::mutex> lock(this->_mtx);
+        this->loadLocked(name, lock);
+        return this->resolveLocked(name, *this->_snapshot);
+    }
+
+    std::shared_ptr<const LanguageManager::Snapshot> LanguageManager::snapshot() const {
+        return std::atomic_load(&this->_snapshot);
+    }
+
+    uint64_t LanguageManager::generation() const {
+        return this->_generation.load(std::memory_order_acquire);
+    }
+
     std::string LanguageManager::localize(std::string key) const {
-        return this->_languages.at(this->_current).localize(key);
+        return this->snapshot()->current->localize(key);
     }
 
     std::string LanguageManager::current_name() const {
-        return this->_current;
+        return this->snapshot()->current_name;
     }
 
-    const Language* LanguageManager::current() const {
-        return &this->_languages.at(this->_current);
+    std::shared_ptr<const Language> LanguageManager::current() const {
+        return this->snapshot()->current;
     }
 
-    LocalizingString::LocalizingString(std::string key) : _key(key) {}
+    LocalizingString::LocalizingString(std::string key) : _key(key), _id(intern(key)) {}
+
+    const std::string& LocalizingString::key() const {
+        return this->_key;
+    }
+
+    MessageId LocalizingString::id() const {
+        return this->_id;
+    }
 
     std::string LocalizingString::localize(const LanguageManager& languages) const {
-        return languages.localize(this->_key);
+        // 快照只在这个函数里有效，先复制再释放。
+        auto language = languages.current();
+        return std::string(this->localize(*language));
     }
 
-    Text::Text() = default;
+    std::string_view LocalizingString::localize(const Language& language) const {
+        if (auto value = language.find(this->_id)) return *value;
+        return this->_key;
+    }
+
+    Text::Text() : _parts(std::make_shared<const Parts>()) {}
 
     Text::Text(const Text& text) = default;
 
-    Text::Text(const LocalizingString& string) : _parts({ string }) {}
+    Text::Text(const LocalizingString& string) : _parts(std::make_shared<const Parts>(Parts{ string })) {}
 
-    Text::Text(const std::string& string) : _parts({ string }) {}
+    Text::Text(const std::string& string) : _parts(std::make_shared<const Parts>(Parts{ string })) {}
 
-    Text::Text(const char* string) : _parts({ string }) {}
+    Text::Text(const char* string) : _parts(std::make_shared<const Parts>(Parts{ std::string(string) })) {}
 
     Text Text::operator+(const Text& that) const {
         Text result = *this;
-        result._parts.insert(result._parts.end(), that._parts.begin(), that._parts.end());
+        result += that;
         return result;
     }
 
     Text& Text::operator+=(const Text& that) {
-        this->_parts.insert(this->_parts.end(), that._parts.begin(), that._parts.end());
+        auto parts = std::make_shared<Parts>(*this->_parts);
+        parts->insert(parts->end(), that._parts->begin(), that._parts->end());
+        this->_parts = std::move(parts);
+        this->_cache_generation = 0;
         return *this;
     }
 
-    std::string Text::localize(const LanguageManager& languages) const {
-        if (this->_cache_language != languages.current()) {
-            this->_cache_language = languages.current();
-            std::ostringstream oss;
-            for (auto& part : this->_parts) {
-                std::visit([&oss, &languages](auto& arg) {
+    const std::string& Text::localize(const LanguageManager& languages) const {
+        if (this->_cache_generation != languages.generation()) {
+            // 只取一次快照，保证语言和代数一致。
+            auto snapshot = languages.snapshot();
+            const Language& language = *snapshot->current;
+            // 用到的译文都没变时只更新代数。
+            bool changed = this->_cache_generation == 0;
+            for (auto& part : *this->_parts) {
+                if (changed) break;
+                if (auto* string = std::get_if<LocalizingString>(&part)) {
+                    changed = snapshot->changedSince(string->id(), this->_cache_generation);
+                }
+            }
+            this->_cache_generation = snapshot->generation;
+            if (!changed) return this->_cache;
+            this->_cache.clear();
+            for (auto& part : *this->_parts) {
+                std::visit([this, &language](auto& arg) {
                     if constexpr (std::is_same_v<std::decay_t<decltype(arg)>, LocalizingString>) {
-                        oss << arg.localize(languages);
+                        this->_cache += arg.localize(language);
                     }
                     else if constexpr (std::is_same_v<std::decay_t<decltype(arg)>, std::string>) {
-                        oss << arg;
+                        this->_cache += arg;
                     }
                     }, part);
             }
-            this->_cache = oss.str();
         }
         return this->_cache;
     }
 
+    std::string Text::localize(const Language& language) const {
+        std::string result;
+        for (auto& part : *this->_parts) {
+            std::visit([&result, &language](auto& arg) {
+                if constexpr (std::is_same_v<std::decay_t<decltype(arg)>, LocalizingString>) {
+                    result += arg.localize(language);
+                }
+                else if constexpr (std::is_same_v<std::decay_t<decltype(arg)>, std::string>) {
+                    result += arg;
+                }
+                }, part);
+        }
+        return result;
+    }
+
+    bool Text::prime(const Text& source, std::string value, uint64_t generation) const {
+        if (this->_parts != source._parts) return false;
+        this->_cache = std::move(value);
+        this->_cache_generation = generation;
+        return true;
+    }
+
     size_t Text::size() const {
-        return this->_parts.size();
+        return this->_parts->size();
     }
 
 }
\ No newline at end of file
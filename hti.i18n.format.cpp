@@ -0,0 +1,289 @@
+#include "hti.hpp"
+#include <charconv>
+
+namespace hti::i18n {
+
+    Arg::Arg(std::string_view name, double value) : name(name), value(value) {}
+
+    Arg::Arg(std::string_view name, std::string_view value) : name(name), value(value) {}
+
+    Arg::Arg(std::string_view name, const char* value) : name(name), value(std::string_view(value)) {}
+
+    Arg::Arg(std::string_view name, const std::string& value) : name(name), value(std::string_view(value)) {}
+
+    // 模板嵌套的最大深度。
+    static const int MAX_FORMAT_DEPTH = 16;
+
+    static bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    static void skipSpaces(std::string_view pattern, size_t& pos) {
+        while (pos < pattern.size() && isSpace(pattern[pos])) pos++;
+    }
+
+    // 读取一个名字，到空白、逗号或花括号为止。
+    static std::string_view readName(std::string_view pattern, size_t& pos) {
+        const size_t begin = pos;
+        while (pos < pattern.size() && !isSpace(pattern[pos]) &&
+            pattern[pos] != ',' && pattern[pos] != '{' && pattern[pos] != '}') {
+            pos++;
+        }
+        return pattern.substr(begin, pos - begin);
+    }
+
+    MessageFormat::MessageFormat(std::string_view pattern) {
+        size_t pos = 0;
+        this->parse(pattern, pos, 0, false, false, this->_first, this->_count);
+    }
+
+    bool MessageFormat::needed(std::string_view pattern) {
+        return pattern.find('{') != std::string_view::npos;
+    }
+
+    void MessageFormat::parse(std::string_view pattern, size_t& pos, int depth, bool nested, bool plural, uint32_t& first, uint32_t& count) {
+        if (depth > MAX_FORMAT_DEPTH) {
+            throw std::runtime_error("Message format is nested too deeply.");
+        }
+        // 嵌套的节点先写入 _nodes，所以本层的节点先放在局部变量里，最后一起追加，保证连续。
+        std::vector<Node> nodes;
+        size_t literal = pos;
+        auto flush = [&]() {
+            if (pos > literal) nodes.push_back({ Node::LITERAL, pattern.substr(literal, pos - literal), 0, 0 });
+        };
+        while (pos < pattern.size()) {
+            const char c = pattern[pos];
+            if (c == '}' && nested) break;
+            if (c == '#' && plural) {
+                flush();
+                nodes.push_back({ Node::POUND, {}, 0, 0 });
+                literal = ++pos;
+                continue;
+            }
+            if (c == '\'') {
+                this->quote(pattern, pos, plural, nodes, literal);
+                continue;
+            }
+            if (c != '{') {
+                pos++;
+                continue;
+            }
+            flush();
+            pos++;
+            skipSpaces(pattern, pos);
+            Node node = { Node::ARGUMENT, readName(pattern, pos), 0, 0 };
+            if (node.text.empty()) {
+                throw std::runtime_error("Message format has an empty argument name.");
+            }
+            skipSpaces(pattern, pos);
+            if (pos < pattern.size() && pattern[pos] == ',') {
+                pos++;
+                skipSpaces(pattern, pos);
+                const std::string_view type = readName(pattern, pos);
+                if (type == "plural") node.kind = Node::PLURAL;
+                else if (type == "select") node.kind = Node::SELECT;
+                else throw std::runtime_error("Unknown message format type: " + std::string(type) + ".");
+                skipSpaces(pattern, pos);
+                if (pos >= pattern.size() || pattern[pos] != ',') {
+                    throw std::runtime_error("Message format expects `,` after the type.");
+                }
+                pos++;
+                // 同样，本层的分支最后一起追加。
+                std::vector<Case> cases;
+                while (true) {
+                    skipSpaces(pattern, pos);
+                    if (pos >= pattern.size() || pattern[pos] == '}') break;
+                    Case branch = { readName(pattern, pos), 0, 0 };
+                    skipSpaces(pattern, pos);
+                    if (branch.key.empty() || pos >= pattern.size() || pattern[pos] != '{') {
+                        throw std::runtime_error("Message format expects `{` after a selector.");
+                    }
+                    pos++;
+                    this->parse(pattern, pos, depth + 1, true, node.kind == Node::PLURAL, branch.first, branch.count);
+                    pos++; // 跳过 }。
+                    cases.push_back(branch);
+                }
+                node.first = uint32_t(this->_cases.size());
+                node.count = uint32_t(cases.size());
+                this->_cases.insert(this->_cases.end(), cases.begin(), cases.end());
+            }
+            if (pos >= pattern.size() || pattern[pos] != '}') {
+                throw std::runtime_error("Message format expects `}`.");
+            }
+            nodes.push_back(node);
+            literal = ++pos;
+        }
+        if (nested && pos >= pattern.size()) {
+            throw std::runtime_error("Message format expects `}`.");
+        }
+        flush();
+        first = uint32_t(this->_nodes.size());
+        count = uint32_t(nodes.size());
+        this->_nodes.insert(this->_nodes.end(), nodes.begin(), nodes.end());
+    }
+
+    void MessageFormat::quote(std::string_view pattern, size_t& pos, bool plural, std::vector<Node>& nodes, size_t& literal) {
+        auto flush = [&]() {
+            if (pos > literal) nodes.push_back({ Node::LITERAL, pattern.substr(literal, pos - literal), 0, 0 });
+        };
+        // '' 是一个单引号，保留前一个，跳过后一个。
+        if (pos + 1 < pattern.size() && pattern[pos + 1] == '\'') {
+            pos++;
+            flush();
+            literal = ++pos;
+            return;
+        }
+        // 其他位置的单引号就是普通字符。
+        const char next = pos + 1 < pattern.size() ? pattern[pos + 1] : '\0';
+        if (next != '{' && next != '}' && !(next == '#' && plural)) {
+            pos++;
+            return;
+        }
+        // 引起来的部分原样输出，到下一个单引号为止，没有闭合时到结尾。
+        flush();
+        literal = ++pos;
+        while (pos < pattern.size()) {
+            if (pattern[pos] != '\'') {
+                pos++;
+                continue;
+            }
+            if (pos + 1 < pattern.size() && pattern[pos + 1] == '\'') {
+                pos++;
+                flush();
+                literal = ++pos;
+                continue;
+            }
+            break;
+        }
+        flush();
+        if (pos < pattern.size()) pos++;
+        literal = pos;
+    }
+
+    // 追加参数值，数字用 to_chars，不分配内存。
+    static void appendValue(std::string& output, const Arg& arg) {
+        char buffer[32];
+        if (auto* value = std::get_if<int64_t>(&arg.value)) {
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), *value);
+            output.append(buffer, result.ptr);
+        }
+        else if (auto* value = std::get_if<double>(&arg.value)) {
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), *value);
+            output.append(buffer, result.ptr);
+        }
+        else output += std::get<std::string_view>(arg.value);
+    }
+
+    void MessageFormat::run(std::string& output, uint32_t first, uint32_t count, const Arg* args, size_t size, const Arg* pound) const {
+        for (uint32_t i = first; i < first + count; i++) {
+            const Node& node = this->_nodes[i];
+            if (node.kind == Node::LITERAL) {
+                output += node.text;
+                continue;
+            }
+            if (node.kind == Node::POUND) {
+                if (pound) appendValue(output, *pound);
+                else output += '#';
+                continue;
+            }
+            const Arg* arg = nullptr;
+            for (size_t j = 0; j < size; j++) {
+                if (args[j].name == node.text) {
+                    arg = &args[j];
+                    break;
+                }
+            }
+            if (!arg) {
+                output += '{';
+                output += node.text;
+                output += '}';
+                continue;
+            }
+            if (node.kind == Node::ARGUMENT) {
+                appendValue(output, *arg);
+                continue;
+            }
+            // 依次匹配分支，找不到时用 other。
+            const Case* chosen = nullptr;
+            const Case* other = nullptr;
+            for (uint32_t j = node.first; j < node.first + node.count && !chosen; j++) {
+                const Case& branch = this->_cases[j];
+                if (branch.key == "other") {
+                    other = &branch;
+                    continue;
+                }
+                if (node.kind == Node::SELECT) {
+                    if (auto* value = std::get_if<std::string_view>(&arg->value); value && *value == branch.key) {
+                        chosen = &branch;
+                    }
+                    continue;
+                }
+                double number = 0;
+                if (auto* value = std::get_if<int64_t>(&arg->value)) number = double(*value);
+                else if (auto* value = std::get_if<double>(&arg->value)) number = *value;
+                else continue;
+                if (branch.key[0] == '=') {
+                    double exact = 0;
+                    auto result = std::from_chars(branch.key.data() + 1, branch.key.data() + branch.key.size(), exact);
+                    if (result.ec == std::errc() && exact == number) chosen = &branch;
+                }
+                else if (branch.key == "one" && number == 1) chosen = &branch;
+            }
+            if (!chosen) chosen = other;
+            if (chosen) this->run(output, chosen->first, chosen->count, args, size, node.kind == Node::PLURAL ? arg : pound);
+        }
+    }
+
+    void MessageFormat::format(std::string& output, const Arg* args, size_t size) const {
+        this->run(output, this->_first, this->_count, args, size, nullptr);
+    }
+
+    void MessageFormat::format(std::string& output, std::initializer_list<Arg> args) const {
+        this->format(output, args.begin(), args.size());
+    }
+
+    Message::Message(const LocalizingString& key) : _key(key) {}
+
+    Message& Message::set(std::string_view name, double value) {
+        return this->assign(name, value);
+    }
+
+    Message& Message::set(std::string_view name, std::string_view value) {
+        for (auto& [n, v] : this->_values) {
+            if (n != name) continue;
+            auto* current = std::get_if<std::string>(&v);
+            if (!current) v = std::string(value);
+            else if (*current != value) current->assign(value.data(), value.size()); // 复用容量。
+            else return *this;
+            this->_cache_generation = 0;
+            return *this;
+        }
+        this->_values.emplace_back(std::string(name), std::string(value));
+        this->_cache_generation = 0;
+        return *this;
+    }
+
+    const std::string& Message::localize(const LanguageManager& languages) const {
+        if (this->_cache_generation == languages.generation()) return this->_cache;
+        auto snapshot = languages.snapshot();
+        const bool changed = this->_cache_generation == 0 || snapshot->changedSince(this->_key.id(), this->_cache_generation);
+        this->_cache_generation = snapshot->generation;
+        if (!changed) return this->_cache;
+        this->_cache.clear();
+        if (auto* format = snapshot->current->format(this->_key.id())) {
+            this->_args.clear();
+            for (const auto& [name, value] : this->_values) {
+                std::visit([this, &name](auto& arg) {
+                    if constexpr (std::is_same_v<std::decay_t<decltype(arg)>, std::string>) {
+                        this->_args.emplace_back(name, std::string_view(arg));
+                    }
+                    else this->_args.emplace_back(name, arg);
+                    }, value);
+            }
+            format->format(this->_cache, this->_args.data(), this->_args.size());
+        }
+        else this->_cache += this->_key.localize(*snapshot->current);
+        return this->_cache;
+    }
+
+}
@@ -0,0 +1,96 @@
+#include "hti.hpp"
+
+namespace hti {
+
+	ObservableBase::ObservableBase() : _app(nullptr) {}
+
+	ObservableBase::~ObservableBase() = default;
+
+	void ObservableBase::notify() {
+		Application* app = this->_app.load(std::memory_order_acquire);
+		if (app) app->markDirty();
+	}
+
+	void ObservableBase::attach(Application* app) {
+		this->_app.store(app, std::memory_order_release);
+	}
+
+	Observable<std::string>::Observable(std::string value)
+		: _value(std::make_shared<const std::string>(std::move(value))) {
+	}
+
+	void Observable<std::string>::store(std::string value) {
+		std::atomic_store(&this->_value, std::shared_ptr<const std::string>(
+			std::make_shared<const std::string>(std::move(value))));
+		this->notify();
+	}
+
+	std::shared_ptr<const std::string> Observable<std::string>::load() const {
+		return std::atomic_load(&this->_value);
+	}
+
+	std::string Observable<std::string>::toString() const {
+		return *this->load();
+	}
+
+	SampleRing::SampleRing(size_t capacity)
+		: _samples(new Slot[capacity ? capacity : 1]),
+		_capacity(capacity ? capacity : 1), _claimed(0), _count(0) {
+		for (size_t i = 0; i < this->_capacity; i++) {
+			this->_samples[i].sequence.store(0, std::memory_order_relaxed);
+			this->_samples[i].value.store(0.0, std::memory_order_relaxed);
+		}
+	}
+
+	void SampleRing::push(double value) {
+		const size_t index = this->_claimed.fetch_add(1, std::memory_order_relaxed);
+		Slot& slot = this->_samples[index % this->_capacity];
+		// 先写槽位再发布计数，读者看到的最新样本一定已经写完。
+		slot.sequence.store(0, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		slot.value.store(value, std::memory_order_relaxed);
+		slot.sequence.store(index + 1, std::memory_order_release);
+		// 多个线程可能乱序写完，计数只往前推。
+		size_t count = this->_count.load(std::memory_order_relaxed);
+		while (count < index + 1 && !this->_count.compare_exchange_weak(count, index + 1,
+			std::memory_order_release, std::memory_order_relaxed));
+		this->notify();
+	}
+
+	size_t SampleRing::capacity() const { return this->_capacity; }
+
+	size_t SampleRing::size() const {
+		return std::min(this->_count.load(std::memory_order_acquire), this->_capacity);
+	}
+
+	size_t SampleRing::count() const {
+		return this->_count.load(std::memory_order_acquire);
+	}
+
+	double SampleRing::back(size_t age) const {
+		const size_t count = this->count();
+		if (age >= std::min(count, this->_capacity)) return std::numeric_limits<double>::quiet_NaN();
+		return this->at(count - 1 - age);
+	}
+
+	double SampleRing::at(size_t index) const {
+		const size_t count = this->count();
+		if (index >= count || count - index > this->_capacity) return std::numeric_limits<double>::quiet_NaN();
+		const Slot& slot = this->_samples[index % this->_capacity];
+		// 序号前后一致且等于要找的样本，才说明读到的值没有被改写。
+		const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+		const double value = slot.value.load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (sequence != index + 1 || slot.sequence.load(std::memory_order_relaxed) != sequence) {
+			return std::numeric_limits<double>::quiet_NaN();
+		}
+		return value;
+	}
+
+	std::string SampleRing::toString() const {
+		std::ostringstream oss;
+		if (this->size()) oss << this->back();
+		return oss.str();
+	}
+
+}
@@ -7,8 +7,8 @@ namespace hti::widgets {
 	}
 
 	std::string Button::onRender(bool focus) {
-		if (focus) return "[" + this->text().localize(this->app()->languages()) + "]";
-		else return "." + this->text().localize(this->app()->languages()) + ".";
+		if (focus) return "[" + this->localized() + "]";
+		else return "." + this->localized() + ".";
 	}
 
 	void Button::bind(WidFunc action) {
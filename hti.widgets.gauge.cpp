@@ -0,0 +1,61 @@
+#include "hti.hpp"
+#include <cmath>
+
+namespace hti::widgets {
+
+	Gauge::Gauge(Widget* parent, std::shared_ptr<SampleRing> samples, double min, double max, size_t width)
+		: Widget(parent), _min(min), _max(max), _width(width), _peak(std::numeric_limits<double>::quiet_NaN()) {
+		this->bind(samples);
+	}
+
+	void Gauge::bind(std::shared_ptr<SampleRing> samples) {
+		if (samples) samples->attach(this->app());
+		this->app()->tryPostEvent(std::make_shared<LambdaEvent>([self = this, samples](Event*) {
+			self->_samples = samples;
+			self->_value = 0.0;
+			self->_peak = std::numeric_limits<double>::quiet_NaN();
+			self->_seen = 0;
+			}));
+	}
+
+	void Gauge::update() {
+		const size_t count = this->_samples->count();
+		const size_t capacity = this->_samples->capacity();
+		const size_t oldest = count > capacity ? count - capacity : 0;
+		size_t from = std::max(this->_seen, oldest);
+		// 峰值移出了窗口，重新扫描整个窗口；平时只看新样本。
+		if (!std::isnan(this->_peak) && this->_peak_index < oldest) {
+			this->_peak = std::numeric_limits<double>::quiet_NaN();
+			from = oldest;
+		}
+		size_t next = count;
+		for (size_t i = from; i < count; i++) {
+			const double sample = this->_samples->at(i);
+			if (std::isnan(sample)) {
+				// 还没写完的样本下一帧再看，最新值保持上一次发布的。
+				if (next == count) next = i;
+				continue;
+			}
+			this->_value = sample;
+			if (std::isnan(this->_peak) || sample >= this->_peak) {
+				this->_peak = sample;
+				this->_peak_index = i;
+			}
+		}
+		this->_seen = next;
+	}
+
+	std::string Gauge::onRender(bool) {
+		if (this->_samples) this->update();
+		const double value = this->_value;
+		const double peak = std::isnan(this->_peak) ? value : this->_peak;
+		const double range = this->_max - this->_min;
+		std::string output = "[";
+		ProgressBar::bar(output, range > 0.0 ? (value - this->_min) / range : 0.0, this->_width);
+		char buffer[64];
+		snprintf(buffer, sizeof(buffer), "] %.1f ^%.1f", value, peak);
+		output += buffer;
+		return output;
+	}
+
+}
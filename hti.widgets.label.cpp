@@ -8,7 +8,7 @@ namespace hti::widgets {
 
 	TextWidget::~TextWidget() = default;
 
-	i18n::Text TextWidget::text() const {
+	const i18n::Text& TextWidget::text() const {
 		return this->_text;
 	}
 
@@ -18,12 +18,28 @@ namespace hti::widgets {
 			}));
 	}
 
+	const std::string& TextWidget::localized() const {
+		return this->_text.localize(this->app()->languages());
+	}
+
+	void TextWidget::collectTexts(std::vector<const i18n::Text*>& texts) const {
+		texts.push_back(&this->_text);
+	}
+
 	Label::Label(Widget* parent, i18n::Text text)
 		: Widget(parent), TextWidget(parent, text) {
 	}
 
+	void Label::bind(std::shared_ptr<ObservableBase> value) {
+		if (value) value->attach(this->app());
+		this->app()->tryPostEvent(std::make_shared<LambdaEvent>([self = this, value](Event*) {
+			self->_value = value;
+			}));
+	}
+
 	std::string Label::onRender(bool focus) {
-		return this->text().localize(this->app()->languages());
+		if (this->_value) return this->localized() + this->_value->toString();
+		return this->localized();
 	}
 
 }
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "hti.hpp"
+
+namespace hti::widgets {
+
+	LogView::LogView(Widget* parent, size_t rows, size_t capacity, size_t limit)
+		: Widget(parent), SelectableWidget(parent),
+		_queue(capacity), _pending(false), _dropped(0), _limit(limit), _rows(rows) {
+	}
+
+	bool LogView::append(std::string line) {
+		if (!this->_queue.push(std::move(line))) {
+			this->_dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		// 在主线程取出，不依赖渲染，隐藏的视图也不会让队列堆满。
+		// 取出之前到达的行不再重复投递事件。
+		if (!this->_pending.exchange(true, std::memory_order_acq_rel)) {
+			this->app()->tryPostEvent(std::make_shared<LambdaEvent>([self = this](Event*) {
+				self->drain();
+				}));
+		}
+		return true;
+	}
+
+	void LogView::drain() {
+		// 先清除标记，之后到达的行会再次通知。
+		this->_pending.store(false, std::memory_order_release);
+		std::string line;
+		size_t added = 0;
+		while (this->_queue.pop(line)) {
+			this->_bytes += line.size();
+			this->_lines.push_back(std::move(line));
+			added++;
+		}
+		// 没有跟随时保持视图不动。
+		if (!this->_follow) this->_offset += added;
+		while (this->_bytes > this->_limit && !this->_lines.empty()) {
+			this->_bytes -= this->_lines.front().size();
+			this->_lines.pop_front();
+			this->_evicted++;
+		}
+		const size_t max = this->_lines.size() > this->_rows ? this->_lines.size() - this->_rows : 0;
+		if (this->_offset > max) this->_offset = max;
+	}
+
+	size_t LogView::dropped() const {
+		return this->_dropped.load(std::memory_order_relaxed);
+	}
+
+	size_t LogView::evicted() const { return this->_evicted; }
+
+	bool LogView::follow() const { return this->_follow; }
+
+	void LogView::follow(bool follow) {
+		this->app()->tryPostEvent(std::make_shared<LambdaEvent>([self = this, follow](Event*) {
+			self->_follow = follow;
+			if (follow) self->_offset = 0;
+			}));
+	}
+
+	std::string LogView::onRender(bool) {
+		const size_t end = this->_lines.size() - this->_offset;
+		const size_t begin = end > this->_rows ? end - this->_rows : 0;
+		std::string output;
+		for (size_t i = begin; i < end; i++) {
+			if (i != begin) output += "\n";
+			output += this->_lines[i];
+		}
+		return output;
+	}
+
+	bool LogView::onKeyPress(Key key) {
+		const size_t max = this->_lines.size() > this->_rows ? this->_lines.size() - this->_rows : 0;
+		// 到达边缘时不处理，交给父控件切换焦点。
+		if (key.isUp()) {
+			if (this->_offset >= max) return false;
+			this->_offset++;
+			this->_follow = false;
+			return true;
+		}
+		if (key.isDown()) {
+			if (this->_offset == 0) return false;
+			this->_offset--;
+			if (this->_offset == 0) this->_follow = true;
+			return true;
+		}
+		return false;
+	}
+
+}
@@ -106,9 +106,14 @@ namespace hti::widgets {
 		return false;
 	}
 
+	void PageStack::collectTexts(std::vector<const i18n::Text*>& texts) const {
+		TextWidget::collectTexts(texts);
+		for (const auto& i : this->_navigation) texts.push_back(&i.first);
+	}
+
 	std::string PageStack::onRender(bool focus) {
 		std::ostringstream oss;
-		std::string title = this->text().localize(this->app()->languages());
+		const std::string& title = this->localized();
 		if (title != "") {
 			if (focus) oss << "<" << title << ">\n";
 			else oss << "." << title << ".\n";
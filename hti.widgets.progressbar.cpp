@@ -0,0 +1,38 @@
+#include "hti.hpp"
+
+namespace hti::widgets {
+
+	ProgressBar::ProgressBar(Widget* parent, std::shared_ptr<Observable<double>> value, size_t width)
+		: Widget(parent), _width(width) {
+		this->bind(value);
+	}
+
+	void ProgressBar::bind(std::shared_ptr<Observable<double>> value) {
+		if (value) value->attach(this->app());
+		this->app()->tryPostEvent(std::make_shared<LambdaEvent>([self = this, value](Event*) {
+			self->_value = value;
+			}));
+	}
+
+	void ProgressBar::bar(std::string& output, double ratio, size_t width) {
+		if (!(ratio >= 0.0)) ratio = 0.0; // 顺便处理 NaN。
+		if (ratio > 1.0) ratio = 1.0;
+		const size_t eighths = size_t(ratio * double(width * 8) + 0.5);
+		const size_t full = eighths / 8, part = eighths % 8;
+		for (size_t i = 0; i < full; i++) chh::appendUtf8(output, U'\u2588');
+		// U+2589 到 U+258F 依次是 7/8 到 1/8。
+		if (part) chh::appendUtf8(output, char32_t(0x2590 - part));
+		output.append(width - full - (part ? 1 : 0), ' ');
+	}
+
+	std::string ProgressBar::onRender(bool) {
+		double value = this->_value ? this->_value->load() : 0.0;
+		if (!(value >= 0.0)) value = 0.0;
+		if (value > 1.0) value = 1.0;
+		std::string output = "[";
+		bar(output, value, this->_width);
+		output += "] " + std::to_string(int(value * 100.0 + 0.5)) + "%";
+		return output;
+	}
+
+}
@@ -0,0 +1,70 @@
+#include "hti.hpp"
+#include <cmath>
+
+namespace hti::widgets {
+
+	Sparkline::Sparkline(Widget* parent, std::shared_ptr<SampleRing> samples, size_t width, double min, double max, Style style)
+		: Widget(parent), _min(min), _max(max), _width(width), _style(style) {
+		this->bind(samples);
+	}
+
+	void Sparkline::bind(std::shared_ptr<SampleRing> samples) {
+		if (samples) samples->attach(this->app());
+		this->app()->tryPostEvent(std::make_shared<LambdaEvent>([self = this, samples](Event*) {
+			self->_samples = samples;
+			}));
+	}
+
+	std::string Sparkline::onRender(bool) {
+		const size_t per = this->_style == STYLE_BRAILLE ? 2 : 1;
+		const size_t count = this->_width * per;
+		const size_t size = this->_samples ? std::min(this->_samples->size(), count) : 0;
+		// 最旧的样本在最左边，右侧对齐。
+		auto sample = [&](size_t column) {
+			if (column + size < count) return std::numeric_limits<double>::quiet_NaN();
+			return this->_samples->back(count - 1 - column);
+		};
+		double min = this->_min, max = this->_max;
+		if (min == max && size) {
+			// 跳过还没写完的样本（NaN）。
+			bool found = false;
+			for (size_t i = 0; i < size; i++) {
+				const double value = this->_samples->back(i);
+				if (std::isnan(value)) continue;
+				min = found ? std::min(min, value) : value;
+				max = found ? std::max(max, value) : value;
+				found = true;
+			}
+		}
+		const double range = max > min ? max - min : 1.0;
+		// 映射到 0 到 levels - 1，没有样本返回 -1。
+		auto level = [&](double value, int levels) {
+			const double ratio = (value - min) / range;
+			if (!std::isfinite(ratio)) return -1;
+			return int(std::clamp(ratio, 0.0, 1.0) * (levels - 1) + 0.5);
+		};
+		std::string output;
+		output.reserve(this->_width * 3);
+		for (size_t i = 0; i < this->_width; i++) {
+			if (this->_style == STYLE_BRAILLE) {
+				// 盲文点阵从下往上：左列 7、3、2、1，右列 8、6、5、4。
+				static const unsigned left[] = { 0x40, 0x04, 0x02, 0x01 };
+				static const unsigned right[] = { 0x80, 0x20, 0x10, 0x08 };
+				const int l = level(sample(i * 2), 4), r = level(sample(i * 2 + 1), 4);
+				unsigned dots = 0;
+				for (int j = 0; j <= l; j++) dots |= left[j];
+				for (int j = 0; j <= r; j++) dots |= right[j];
+				if (dots) chh::appendUtf8(output, char32_t(0x2800 + dots));
+				else output += ' ';
+			}
+			else {
+				// U+2581 到 U+2588 是 1/8 到 8/8 高的方块。
+				const int l = level(sample(i), 8);
+				if (l >= 0) chh::appendUtf8(output, char32_t(0x2581 + l));
+				else output += ' ';
+			}
+		}
+		return output;
+	}
+
+}
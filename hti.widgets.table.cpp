@@ -0,0 +1,187 @@
+#include "hti.hpp"
+#include <algorithm>
+#include <numeric>
+
+namespace hti::widgets {
+
+	TableSource::~TableSource() = default;
+
+	std::string TableSource::header(size_t) const { return ""; }
+
+	int TableSource::compare(size_t a, size_t b, size_t column) const {
+		return this->cell(a, column).compare(this->cell(b, column));
+	}
+
+	ColumnTableSource::ColumnTableSource(std::vector<std::string> headers, std::vector<std::vector<std::string>> columns)
+		: _headers(std::move(headers)), _columns(std::move(columns)) {
+		for (const auto& i : this->_columns) {
+			if (i.size() != this->_columns.front().size()) {
+				throw std::runtime_error("Columns of a table must have the same length.");
+			}
+		}
+		this->_headers.resize(this->_columns.size());
+	}
+
+	size_t ColumnTableSource::rows() const {
+		return this->_columns.empty() ? 0 : this->_columns.front().size();
+	}
+
+	size_t ColumnTableSource::columns() const { return this->_columns.size(); }
+
+	std::string ColumnTableSource::header(size_t column) const { return this->_headers[column]; }
+
+	std::string ColumnTableSource::cell(size_t row, size_t column) const {
+		return this->_columns[column][row];
+	}
+
+	int ColumnTableSource::compare(size_t a, size_t b, size_t column) const {
+		return this->_columns[column][a].compare(this->_columns[column][b]);
+	}
+
+	// 按显示宽度截断或用空格填充到固定宽度。
+	// 不会截断在字符中间；放不下的宽字符用空格补齐。
+	static void fit(std::ostringstream& oss, const std::string& str, size_t width) {
+		size_t used = 0, pos = 0;
+		while (pos < str.size()) {
+			size_t next = pos;
+			const size_t w = chh::displayWidth(chh::nextUtf8(str, next));
+			if (used + w > width) break;
+			used += w;
+			pos = next;
+		}
+		oss.write(str.data(), pos);
+		oss << std::string(width - used, ' ');
+	}
+
+	Table::Table(Widget* parent, std::shared_ptr<const TableSource> source, size_t rows, size_t width)
+		: Widget(parent), SelectableWidget(parent), _source(source), _rows(rows), _width(width) {
+	}
+
+	size_t Table::row(size_t index) const {
+		return this->_order.empty() ? index : this->_order[index];
+	}
+
+	void Table::measure(const TableSource& source) {
+		const size_t rows = source.rows(), columns = source.columns();
+		this->_widths.assign(columns, 1);
+		const size_t step = std::max<size_t>(1, rows / SAMPLE_ROWS);
+		for (size_t c = 0; c < columns; c++) {
+			size_t width = chh::displayWidth(source.header(c));
+			for (size_t r = 0; r < rows; r += step) {
+				width = std::max(width, chh::displayWidth(source.cell(r, c)));
+			}
+			this->_widths[c] = std::clamp(width, size_t(1), MAX_COLUMN_WIDTH);
+		}
+	}
+
+	void Table::source(std::shared_ptr<const TableSource> source) {
+		this->app()->tryPostEvent(std::make_shared<LambdaEvent>([self = this, source](Event*) {
+			std::atomic_store(&self->_source, source);
+			self->_order.clear();
+			self->_widths.clear();
+			self->_top = self->_cursor = self->_left = 0;
+			}));
+	}
+
+	void Table::sort(size_t column, bool ascending) {
+		auto source = std::atomic_load(&this->_source);
+		if (!source || column >= source->columns()) return;
+		const size_t rows = source->rows();
+		if (rows > std::numeric_limits<uint32_t>::max()) {
+			throw std::runtime_error("Too many rows to sort.");
+		}
+		std::vector<uint32_t> order(rows);
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+			int result = source->compare(a, b, column);
+			return ascending ? result < 0 : result > 0;
+			});
+		this->app()->tryPostEvent(std::make_shared<LambdaEvent>(
+			[self = this, source, order = std::move(order)](Event*) mutable {
+				// 排序期间数据源被换掉了，结果作废。
+				if (std::atomic_load(&self->_source) != source) return;
+				self->_order = std::move(order);
+				self->_top = self->_cursor = 0;
+			}));
+	}
+
+	void Table::unsort() {
+		this->app()->tryPostEvent(std::make_shared<LambdaEvent>([self = this](Event*) {
+			self->_order.clear();
+			self->_order.shrink_to_fit();
+			self->_top = self->_cursor = 0;
+			}));
+	}
+
+	size_t Table::selected() const {
+		return this->row(this->_cursor);
+	}
+
+	std::string Table::onRender(bool focus) {
+		auto source = std::atomic_load(&this->_source);
+		if (!source) return "";
+		if (this->_widths.size() != source->columns()) this->measure(*source);
+		const size_t rows = source->rows(), columns = source->columns();
+		if (this->_cursor >= rows) this->_cursor = rows ? rows - 1 : 0;
+		if (this->_top > this->_cursor) this->_top = this->_cursor;
+		if (this->_left >= columns) this->_left = columns ? columns - 1 : 0;
+
+		// 找出在宽度内能显示的列，至少显示一列。
+		size_t end = this->_left, used = 2;
+		while (end < columns && (end == this->_left || used + this->_widths[end] <= this->_width)) {
+			used += this->_widths[end] + 1;
+			end++;
+		}
+
+		std::ostringstream oss;
+		oss << "  ";
+		for (size_t c = this->_left; c < end; c++) {
+			fit(oss, source->header(c), this->_widths[c]);
+			oss << " ";
+		}
+		const size_t last = std::min(rows, this->_top + this->_rows);
+		for (size_t i = this->_top; i < last; i++) {
+			oss << "\n";
+			if (i == this->_cursor) oss << (focus ? "> " : ". ");
+			else oss << "  ";
+			const size_t r = this->row(i);
+			for (size_t c = this->_left; c < end; c++) {
+				fit(oss, source->cell(r, c), this->_widths[c]);
+				oss << " ";
+			}
+		}
+		oss << "\n  " << (rows ? this->_cursor + 1 : 0) << "/" << rows;
+		return oss.str();
+	}
+
+	bool Table::onKeyPress(Key key) {
+		auto source = std::atomic_load(&this->_source);
+		if (!source) return false;
+		const size_t rows = source->rows(), columns = source->columns();
+		// 到达边缘时不处理，交给父控件切换焦点。
+		if (key.isUp()) {
+			if (this->_cursor == 0) return false;
+			this->_cursor--;
+			if (this->_cursor < this->_top) this->_top = this->_cursor;
+			return true;
+		}
+		if (key.isDown()) {
+			if (this->_cursor + 1 >= rows) return false;
+			this->_cursor++;
+			if (this->_cursor >= this->_top + this->_rows) this->_top = this->_cursor + 1 - this->_rows;
+			return true;
+		}
+		if (key.isLeft()) {
+			if (this->_left == 0) return false;
+			this->_left--;
+			return true;
+		}
+		if (key.isRight()) {
+			if (this->_left + 1 >= columns) return false;
+			this->_left++;
+			return true;
+		}
+		return false;
+	}
+
+}
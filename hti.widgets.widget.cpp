@@ -70,6 +70,8 @@ namespace hti::widgets {
 
 	void Widget::onFocusLost() {}
 
+	void Widget::collectTexts(std::vector<const i18n::Text*>&) const {}
+
 	SelectableWidget::SelectableWidget(Widget* parent)
 		: Widget(parent) {
 
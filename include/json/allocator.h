@@ -6,8 +6,10 @@
 #ifndef JSON_ALLOCATOR_H_INCLUDED
 #define JSON_ALLOCATOR_H_INCLUDED
 
+#include <cstddef>
 #include <cstring>
 #include <memory>
+#include <type_traits>
 
 #pragma pack(push, 8)
 
@@ -81,6 +83,124 @@ bool operator!=(const SecureAllocator<T>&, const SecureAllocator<U>&) {
   return false;
 }
 
+#if JSON_USE_VALUE_ARENA
+/** \brief Bump allocator that owns the nodes and strings of a document.
+ *
+ * While a ValueArena::Scope is alive on the current thread, every object
+ * and array map, map node, key and string payload created by Json::Value
+ * is carved out of the arena instead of the heap, and individual frees are
+ * skipped. All of it is released at once when the arena is destroyed, so
+ * the Values built inside the scope must be destroyed before the arena is.
+ * Copies made outside any scope go to the heap as usual, which is how a
+ * value escapes the arena.
+ *
+ * Only available when JSON_USE_VALUE_ARENA is non-zero; otherwise object
+ * maps use the standard allocator and Value never looks for an arena.
+ *
+ * \code
+ * Json::ValueArena arena;
+ * Json::Value root;
+ * {
+ *   Json::ValueArena::Scope scope(arena);
+ *   reader->parse(begin, end, &root, &errs);
+ * }
+ * \endcode
+ */
+class JSON_API ValueArena {
+public:
+  explicit ValueArena(size_t blockSize = 64 * 1024);
+  ~ValueArena();
+  ValueArena(const ValueArena&) = delete;
+  ValueArena& operator=(const ValueArena&) = delete;
+
+  /// Returns \c size bytes aligned to \c alignment. Never returns nullptr.
+  void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+  /// Total bytes reserved from the heap so far.
+  size_t reserved() const { return reserved_; }
+
+  /// The arena of the innermost Scope on this thread, or nullptr.
+  static ValueArena* current();
+
+  /** \brief Makes an arena current on this thread until destroyed.
+   *
+   * Scopes nest; the previous arena is restored on destruction.
+   */
+  class JSON_API Scope {
+  public:
+    explicit Scope(ValueArena& arena);
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    ValueArena* previous_;
+  };
+
+private:
+  struct Block {
+    Block* next_;
+    size_t size_;
+  };
+
+  Block* head_{nullptr};
+  char* cursor_{nullptr};
+  char* end_{nullptr};
+  size_t blockSize_;
+  size_t reserved_{0};
+};
+
+/** \brief Standard allocator that draws from the current ValueArena.
+ *
+ * The arena is captured when the allocator is constructed; with no arena
+ * current it falls back to global operator new. Deallocation of arena
+ * memory is a no-op.
+ */
+template <typename T> class ArenaAllocator {
+public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  ArenaAllocator() : arena_(ValueArena::current()) {}
+  explicit ArenaAllocator(ValueArena* arena) : arena_(arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena()) {}
+
+  T* allocate(std::size_t n) {
+    if (arena_)
+      return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T* p, std::size_t) {
+    if (!arena_)
+      ::operator delete(p);
+  }
+
+  /// Copies of a container follow the arena current at copy time.
+  ArenaAllocator select_on_container_copy_construction() const {
+    return ArenaAllocator();
+  }
+
+  ValueArena* arena() const { return arena_; }
+
+private:
+  ValueArena* arena_;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+  return a.arena() == b.arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+  return a.arena() != b.arena();
+}
+#endif // if JSON_USE_VALUE_ARENA
+
 } // namespace Json
 
 #pragma pack(pop)
@@ -25,6 +25,23 @@
 #define JSON_USE_NULLREF 1
 #endif
 
+// If non-zero, the members of objects and arrays are kept in a sorted vector
+// instead of a std::map. Lookups and iteration touch contiguous memory, but
+// adding or removing a member invalidates references to its siblings, as
+// with std::vector. Building objects with thousands of members out of key
+// order is quadratic, so leave this off for such documents.
+#ifndef JSON_USE_FLAT_OBJECT_VALUES
+#define JSON_USE_FLAT_OBJECT_VALUES 0
+#endif
+
+// If non-zero, Json::ValueArena is available to place whole documents in a
+// bump allocator. Object maps then carry an allocator that records its
+// arena, and every map, key and string allocation checks for a current
+// arena, so leave this off unless documents are built and dropped in bulk.
+#ifndef JSON_USE_VALUE_ARENA
+#define JSON_USE_VALUE_ARENA 0
+#endif
+
 /// If defined, indicates that the source file is amalgamated
 /// to prevent private header inclusion.
 /// Remarks: it is automatically defined in the generated amalgamated header.
@@ -41,6 +41,19 @@
 #pragma warning(disable : 4996)
 #endif
 
+// Define JSONCPP_NO_SIMD to force the scalar scanners.
+#if !defined(JSONCPP_NO_SIMD) &&                                               \
+    (defined(__SSE2__) || defined(_M_X64) ||                                   \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define JSONCPP_USE_SSE2 1
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define JSONCPP_USE_SSE2 0
+#endif
+
 // Define JSONCPP_DEPRECATED_STACK_LIMIT as an appropriate integer at compile
 // time to change the stack limit
 #if !defined(JSONCPP_DEPRECATED_STACK_LIMIT)
@@ -854,6 +867,116 @@ bool Reader::pushError(const Value& value, const String& message,
 
 bool Reader::good() const { return errors_.empty(); }
 
+// Scanners used by OurReader. With SSE2 they test 16 bytes per step and fall
+// back to the scalar loop for the tail; both return the same position.
+
+// Returns the first character in [p, end) that is not JSON whitespace.
+static inline const char* skipWhitespaceScalar(const char* p,
+                                               const char* end) {
+  while (p != end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+    ++p;
+  return p;
+}
+
+// Returns the first \p quote or backslash in [p, end), or end.
+static inline const char* findQuoteOrEscapeScalar(const char* p,
+                                                  const char* end, char quote) {
+  while (p != end && *p != quote && *p != '\\')
+    ++p;
+  return p;
+}
+
+// Returns the first character in [p, end) that is not a decimal digit.
+static inline const char* skipDigitsScalar(const char* p, const char* end) {
+  while (p != end && *p >= '0' && *p <= '9')
+    ++p;
+  return p;
+}
+
+#if JSONCPP_USE_SSE2
+static inline unsigned lowestSetBit(unsigned mask) {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<unsigned>(index);
+#else
+  return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+#endif
+
+// Same result as skipWhitespaceScalar().
+static inline const char* skipWhitespace(const char* p, const char* end) {
+#if JSONCPP_USE_SSE2
+  // Most runs are a single space or a newline plus indentation; only pay for
+  // the vector setup when the run continues.
+  if (p != end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n')
+    return p;
+  const __m128i space = _mm_set1_epi8(' ');
+  const __m128i tab = _mm_set1_epi8('\t');
+  const __m128i cr = _mm_set1_epi8('\r');
+  const __m128i lf = _mm_set1_epi8('\n');
+  while (end - p >= 16) {
+    const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i blank = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, cr), _mm_cmpeq_epi8(chunk, lf)));
+    const unsigned mask = ~static_cast<unsigned>(_mm_movemask_epi8(blank)) &
+                          0xFFFFu;
+    if (mask)
+      return p + lowestSetBit(mask);
+    p += 16;
+  }
+#endif
+  return skipWhitespaceScalar(p, end);
+}
+
+// Same result as findQuoteOrEscapeScalar().
+static inline const char* findQuoteOrEscape(const char* p, const char* end,
+                                            char quote) {
+#if JSONCPP_USE_SSE2
+  const __m128i quotes = _mm_set1_epi8(quote);
+  const __m128i backslashes = _mm_set1_epi8('\\');
+  while (end - p >= 16) {
+    const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, quotes),
+                     _mm_cmpeq_epi8(chunk, backslashes))));
+    if (mask)
+      return p + lowestSetBit(mask);
+    p += 16;
+  }
+#endif
+  return findQuoteOrEscapeScalar(p, end, quote);
+}
+
+// Same result as skipDigitsScalar().
+static inline const char* skipDigits(const char* p, const char* end) {
+#if JSONCPP_USE_SSE2
+  // Short numbers are the norm; only vectorize runs that are still going.
+  for (int i = 0; i < 4; ++i, ++p)
+    if (p == end || *p < '0' || *p > '9')
+      return p;
+  // Shift '0'..'9' to the bottom of the signed range so that one signed
+  // comparison finds everything else.
+  const __m128i bias = _mm_set1_epi8(static_cast<char>(0x80 - '0'));
+  const __m128i limit = _mm_set1_epi8(static_cast<char>(0x80 + 10));
+  while (end - p >= 16) {
+    const __m128i chunk = _mm_add_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), bias);
+    const unsigned mask =
+        ~static_cast<unsigned>(_mm_movemask_epi8(_mm_cmplt_epi8(chunk, limit))) &
+        0xFFFFu;
+    if (mask)
+      return p + lowestSetBit(mask);
+    p += 16;
+  }
+#endif
+  return skipDigitsScalar(p, end);
+}
+
 // Originally copied from the Features class (now deprecated), used internally
 // for features implementation.
 class OurFeatures {
@@ -892,6 +1015,10 @@ public:
   explicit OurReader(OurFeatures const& features);
   bool parse(const char* beginDoc, const char* endDoc, Value& root,
              bool collectComments = true);
+  bool parseEvents(const char* beginDoc, const char* endDoc,
+                   ParseHandler& handler);
+  bool parseInSitu(char* beginDoc, char* endDoc, Value& root,
+                   bool collectComments = true);
   String getFormattedErrorMessages() const;
   std::vector<StructuredError> getStructuredErrors() const;
 
@@ -948,10 +1075,14 @@ private:
   bool readValue();
   bool readObject(Token& token);
   bool readArray(Token& token);
+  bool readEvent();
+  bool readObjectEvents(Token& token);
+  bool readArrayEvents(Token& token);
   bool decodeNumber(Token& token);
   bool decodeNumber(Token& token, Value& decoded);
   bool decodeString(Token& token);
   bool decodeString(Token& token, String& decoded);
+  bool decodeString(Token& token, Location& begin, Location& end);
   bool decodeDouble(Token& token);
   bool decodeDouble(Token& token, Value& decoded);
   bool decodeUnicodeCodePoint(Token& token, Location& current, Location end,
@@ -989,6 +1120,13 @@ private:
 
   OurFeatures const features_;
   bool collectComments_ = false;
+  // The document is writable and string values are decoded in place.
+  bool inSitu_ = false;
+
+  // Only used while streaming events to a ParseHandler.
+  ParseHandler* handler_ = nullptr;
+  size_t depth_ = 0;
+  String scratch_{};
 }; // OurReader
 
 // complete copy of Read impl, for OurReader
@@ -1046,6 +1184,110 @@ bool OurReader::parse(const char* beginDoc, const char* endDoc, Value& root,
   return successful;
 }
 
+bool OurReader::parseInSitu(char* beginDoc, char* endDoc, Value& root,
+                            bool collectComments) {
+  inSitu_ = true;
+  bool successful = parse(beginDoc, endDoc, root, collectComments);
+  inSitu_ = false;
+  return successful;
+}
+
+bool OurReader::parseEvents(const char* beginDoc, const char* endDoc,
+                            ParseHandler& handler) {
+  begin_ = beginDoc;
+  end_ = endDoc;
+  collectComments_ = false;
+  current_ = begin_;
+  lastValueEnd_ = nullptr;
+  lastValue_ = nullptr;
+  commentsBefore_.clear();
+  errors_.clear();
+  handler_ = &handler;
+  depth_ = 0;
+
+  skipBom(features_.skipBom_);
+  bool successful = readEvent();
+  handler_ = nullptr;
+  if (!successful)
+    return false;
+  Token token;
+  skipCommentTokens(token);
+  if (features_.failIfExtra_ && (token.type_ != tokenEndOfStream)) {
+    addError("Extra non-whitespace after JSON value.", token);
+    return false;
+  }
+  return true;
+}
+
+// Streaming counterpart of readValue(): reports the value to handler_ instead
+// of storing it, and stops at the first error.
+bool OurReader::readEvent() {
+  if (depth_ + 1 > features_.stackLimit_)
+    throwRuntimeError("Exceeded stackLimit in readValue().");
+  Token token;
+  skipCommentTokens(token);
+  if (depth_ == 0 && features_.strictRoot_ &&
+      token.type_ != tokenObjectBegin && token.type_ != tokenArrayBegin)
+    return addError(
+        "A valid JSON document must be either an array or an object value.",
+        token);
+
+  bool accepted = true;
+  switch (token.type_) {
+  case tokenObjectBegin:
+    return readObjectEvents(token);
+  case tokenArrayBegin:
+    return readArrayEvents(token);
+  case tokenNumber: {
+    Value decoded;
+    if (!decodeNumber(token, decoded))
+      return false;
+    if (decoded.type() == intValue)
+      accepted = handler_->onInt(decoded.asLargestInt());
+    else if (decoded.type() == uintValue)
+      accepted = handler_->onUInt(decoded.asLargestUInt());
+    else
+      accepted = handler_->onDouble(decoded.asDouble());
+  } break;
+  case tokenString: {
+    Location begin, end;
+    if (!decodeString(token, begin, end))
+      return false;
+    accepted = handler_->onString(begin, end);
+  } break;
+  case tokenTrue:
+    accepted = handler_->onBool(true);
+    break;
+  case tokenFalse:
+    accepted = handler_->onBool(false);
+    break;
+  case tokenNull:
+    accepted = handler_->onNull();
+    break;
+  case tokenNaN:
+    accepted = handler_->onDouble(std::numeric_limits<double>::quiet_NaN());
+    break;
+  case tokenPosInf:
+    accepted = handler_->onDouble(std::numeric_limits<double>::infinity());
+    break;
+  case tokenNegInf:
+    accepted = handler_->onDouble(-std::numeric_limits<double>::infinity());
+    break;
+  case tokenArraySeparator:
+  case tokenObjectEnd:
+  case tokenArrayEnd:
+    if (features_.allowDroppedNullPlaceholders_) {
+      // "Un-read" the current token and report a null.
+      current_--;
+      accepted = handler_->onNull();
+      break;
+    } // else, fall through ...
+  default:
+    return addError("Syntax error: value, object or array expected.", token);
+  }
+  return accepted || addError("Parsing stopped by handler.", token);
+}
+
 bool OurReader::readValue() {
   //  To preserve the old behaviour we cast size_t to int.
   if (nodes_.size() > features_.stackLimit_)
@@ -1259,15 +1501,7 @@ bool OurReader::readToken(Token& token) {
   return ok;
 }
 
-void OurReader::skipSpaces() {
-  while (current_ != end_) {
-    Char c = *current_;
-    if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
-      ++current_;
-    else
-      break;
-  }
-}
+void OurReader::skipSpaces() { current_ = skipWhitespace(current_, end_); }
 
 void OurReader::skipBom(bool skipBom) {
   // The default behavior is to skip BOM.
@@ -1392,48 +1626,41 @@ bool OurReader::readNumber(bool checkInf) {
     current_ = ++p;
     return false;
   }
-  char c = '0'; // stopgap for already consumed character
   // integral part
-  while (c >= '0' && c <= '9')
-    c = (current_ = p) < end_ ? *p++ : '\0';
+  p = skipDigits(p, end_);
   // fractional part
-  if (c == '.') {
-    c = (current_ = p) < end_ ? *p++ : '\0';
-    while (c >= '0' && c <= '9')
-      c = (current_ = p) < end_ ? *p++ : '\0';
-  }
+  if (p != end_ && *p == '.')
+    p = skipDigits(p + 1, end_);
   // exponential part
-  if (c == 'e' || c == 'E') {
-    c = (current_ = p) < end_ ? *p++ : '\0';
-    if (c == '+' || c == '-')
-      c = (current_ = p) < end_ ? *p++ : '\0';
-    while (c >= '0' && c <= '9')
-      c = (current_ = p) < end_ ? *p++ : '\0';
+  if (p != end_ && (*p == 'e' || *p == 'E')) {
+    ++p;
+    if (p != end_ && (*p == '+' || *p == '-'))
+      ++p;
+    p = skipDigits(p, end_);
   }
+  current_ = p;
   return true;
 }
 bool OurReader::readString() {
-  Char c = 0;
-  while (current_ != end_) {
-    c = getNextChar();
-    if (c == '\\')
-      getNextChar();
-    else if (c == '"')
-      break;
+  for (;;) {
+    current_ = findQuoteOrEscape(current_, end_, '"');
+    if (current_ == end_)
+      return false;
+    if (getNextChar() == '"')
+      return true;
+    getNextChar(); // skip the escaped character
   }
-  return c == '"';
 }
 
 bool OurReader::readStringSingleQuote() {
-  Char c = 0;
-  while (current_ != end_) {
-    c = getNextChar();
-    if (c == '\\')
-      getNextChar();
-    else if (c == '\'')
-      break;
+  for (;;) {
+    current_ = findQuoteOrEscape(current_, end_, '\'');
+    if (current_ == end_)
+      return false;
+    if (getNextChar() == '\'')
+      return true;
+    getNextChar(); // skip the escaped character
   }
-  return c == '\'';
 }
 
 bool OurReader::readObject(Token& token) {
@@ -1500,6 +1727,117 @@ bool OurReader::readObject(Token& token) {
                             tokenObjectEnd);
 }
 
+bool OurReader::readObjectEvents(Token& token) {
+  if (!handler_->onObjectBegin())
+    return addError("Parsing stopped by handler.", token);
+  ++depth_;
+  Token tokenName;
+  bool first = true;
+  std::set<String> names;
+  while (readToken(tokenName)) {
+    bool initialTokenOk = true;
+    while (tokenName.type_ == tokenComment && initialTokenOk)
+      initialTokenOk = readToken(tokenName);
+    if (!initialTokenOk)
+      break;
+    if (tokenName.type_ == tokenObjectEnd &&
+        (first || features_.allowTrailingCommas_)) { // empty object or
+                                                     // trailing comma
+      --depth_;
+      return handler_->onObjectEnd() ||
+             addError("Parsing stopped by handler.", tokenName);
+    }
+    first = false;
+    Location begin, end;
+    if (tokenName.type_ == tokenString) {
+      if (!decodeString(tokenName, begin, end))
+        return false;
+    } else if (tokenName.type_ == tokenNumber && features_.allowNumericKeys_) {
+      Value numberName;
+      if (!decodeNumber(tokenName, numberName))
+        return false;
+      scratch_ = numberName.asString();
+      begin = scratch_.data();
+      end = begin + scratch_.size();
+    } else {
+      break;
+    }
+    if (end - begin >= (1 << 30))
+      throwRuntimeError("keylength >= 2^30");
+    if (features_.rejectDupKeys_ && !names.insert(String(begin, end)).second) {
+      String msg = "Duplicate key: '" + String(begin, end) + "'";
+      return addError(msg, tokenName);
+    }
+    if (!handler_->onKey(begin, end))
+      return addError("Parsing stopped by handler.", tokenName);
+
+    Token colon;
+    if (!readToken(colon) || colon.type_ != tokenMemberSeparator) {
+      return addError("Missing ':' after object member name", colon);
+    }
+    if (!readEvent()) // error already set
+      return false;
+
+    Token comma;
+    if (!readToken(comma) ||
+        (comma.type_ != tokenObjectEnd && comma.type_ != tokenArraySeparator &&
+         comma.type_ != tokenComment)) {
+      return addError("Missing ',' or '}' in object declaration", comma);
+    }
+    bool finalizeTokenOk = true;
+    while (comma.type_ == tokenComment && finalizeTokenOk)
+      finalizeTokenOk = readToken(comma);
+    if (comma.type_ == tokenObjectEnd) {
+      --depth_;
+      return handler_->onObjectEnd() ||
+             addError("Parsing stopped by handler.", comma);
+    }
+  }
+  return addError("Missing '}' or object member name", tokenName);
+}
+
+bool OurReader::readArrayEvents(Token& token) {
+  if (!handler_->onArrayBegin())
+    return addError("Parsing stopped by handler.", token);
+  ++depth_;
+  int index = 0;
+  for (;;) {
+    skipSpaces();
+    if (current_ != end_ && *current_ == ']' &&
+        (index == 0 ||
+         (features_.allowTrailingCommas_ &&
+          !features_.allowDroppedNullPlaceholders_))) // empty array or trailing
+                                                      // comma
+    {
+      Token endArray;
+      readToken(endArray);
+      --depth_;
+      return handler_->onArrayEnd() ||
+             addError("Parsing stopped by handler.", endArray);
+    }
+    ++index;
+    if (!readEvent()) // error already set
+      return false;
+
+    Token currentToken;
+    // Accept Comment after last item in the array.
+    bool ok = readToken(currentToken);
+    while (currentToken.type_ == tokenComment && ok) {
+      ok = readToken(currentToken);
+    }
+    bool badTokenType = (currentToken.type_ != tokenArraySeparator &&
+                         currentToken.type_ != tokenArrayEnd);
+    if (!ok || badTokenType) {
+      return addError("Missing ',' or ']' in array declaration", currentToken);
+    }
+    if (currentToken.type_ == tokenArrayEnd) {
+      --depth_;
+      return handler_->onArrayEnd() ||
+             addError("Parsing stopped by handler.", currentToken);
+    }
+  }
+}
+
 bool OurReader::readArray(Token& token) {
   Value init(arrayValue);
   currentValue().swapPayload(init);
@@ -1655,10 +1993,28 @@ bool OurReader::decodeDouble(Token& token, Value& decoded) {
 }
 
 bool OurReader::decodeString(Token& token) {
-  String decoded_string;
-  if (!decodeString(token, decoded_string))
+  if (inSitu_) {
+    // Decoding never makes a string longer, so the result fits where the
+    // escaped text was, and the closing quote leaves room for a terminator.
+    Location begin, end;
+    if (!decodeString(token, begin, end))
+      return false;
+    char* target = const_cast<char*>(token.start_ + 1);
+    if (begin != target)
+      memcpy(target, begin, static_cast<size_t>(end - begin));
+    target[end - begin] = 0;
+    Value decoded(BorrowedString(target, target + (end - begin)));
+    currentValue().swapPayload(decoded);
+    currentValue().setOffsetStart(token.start_ - begin_);
+    currentValue().setOffsetLimit(token.end_ - begin_);
+    return true;
+  }
+  // Short strings are stored inside the Value, so skip the intermediate
+  // String and copy straight from the document when nothing is escaped.
+  Location begin, end;
+  if (!decodeString(token, begin, end))
     return false;
-  Value decoded(decoded_string);
+  Value decoded(begin, end);
   currentValue().swapPayload(decoded);
   currentValue().setOffsetStart(token.start_ - begin_);
   currentValue().setOffsetLimit(token.end_ - begin_);
@@ -1718,6 +2074,21 @@ bool OurReader::decodeString(Token& token, String& decoded) {
   return true;
 }
 
+// Yields the string contents without copying when there is nothing to decode;
+// otherwise decodes into scratch_. The range is valid until the next call.
+bool OurReader::decodeString(Token& token, Location& begin, Location& end) {
+  begin = token.start_ + 1; // skip '"'
+  end = token.end_ - 1;     // do not include '"'
+  if (std::none_of(begin, end, [](Char c) { return c == '\\' || c == '"'; }))
+    return true;
+  scratch_.clear();
+  if (!decodeString(token, scratch_))
+    return false;
+  begin = scratch_.data();
+  end = begin + scratch_.size();
+  return true;
+}
+
 bool OurReader::decodeUnicodeCodePoint(Token& token, Location& current,
                                        Location end, unsigned int& unicode) {
 
@@ -1875,8 +2246,80 @@ public:
     }
     return ok;
   }
+  bool parseInSitu(char* beginDoc, char* endDoc, Value* root,
+                   String* errs) override {
+    bool ok = reader_.parseInSitu(beginDoc, endDoc, *root, collectComments_);
+    if (errs) {
+      *errs = reader_.getFormattedErrorMessages();
+    }
+    return ok;
+  }
+  bool parseEvents(char const* beginDoc, char const* endDoc,
+                   ParseHandler& handler, String* errs) override {
+    bool ok = reader_.parseEvents(beginDoc, endDoc, handler);
+    if (errs) {
+      *errs = reader_.getFormattedErrorMessages();
+    }
+    return ok;
+  }
 };
 
+static bool replay(Value const& value, ParseHandler& handler) {
+  switch (value.type()) {
+  case nullValue:
+    return handler.onNull();
+  case intValue:
+    return handler.onInt(value.asLargestInt());
+  case uintValue:
+    return handler.onUInt(value.asLargestUInt());
+  case realValue:
+    return handler.onDouble(value.asDouble());
+  case stringValue: {
+    char const* begin;
+    char const* end;
+    value.getString(&begin, &end);
+    return handler.onString(begin, end);
+  }
+  case booleanValue:
+    return handler.onBool(value.asBool());
+  case arrayValue:
+    if (!handler.onArrayBegin())
+      return false;
+    for (auto const& item : value)
+      if (!replay(item, handler))
+        return false;
+    return handler.onArrayEnd();
+  case objectValue:
+    if (!handler.onObjectBegin())
+      return false;
+    for (auto it = value.begin(); it != value.end(); ++it) {
+      char const* end;
+      char const* begin = it.memberName(&end);
+      if (!handler.onKey(begin, end) || !replay(*it, handler))
+        return false;
+    }
+    return handler.onObjectEnd();
+  }
+  return false;
+}
+
+bool CharReader::parseInSitu(char* beginDoc, char* endDoc, Value* root,
+                             String* errs) {
+  return parse(beginDoc, endDoc, root, errs);
+}
+
+bool CharReader::parseEvents(char const* beginDoc, char const* endDoc,
+                             ParseHandler& handler, String* errs) {
+  Value root;
+  if (!parse(beginDoc, endDoc, &root, errs))
+    return false;
+  if (replay(root, handler))
+    return true;
+  if (errs)
+    *errs = "Parsing stopped by handler.\n";
+  return false;
+}
+
 CharReaderBuilder::CharReaderBuilder() { setDefaults(&settings_); }
 CharReaderBuilder::~CharReaderBuilder() = default;
 CharReader* CharReaderBuilder::newCharReader() const {
@@ -1979,6 +2422,82 @@ bool parseFromStream(CharReader::Factory const& fact, IStream& sin, Value* root,
   return reader->parse(begin, end, root, errs);
 }
 
+//////////////////////////////////
+// StreamReader
+
+StreamReader::StreamReader() : StreamReader(CharReaderBuilder()) {}
+
+StreamReader::StreamReader(CharReader::Factory const& factory)
+    : reader_(factory.newCharReader()) {}
+
+StreamReader::~StreamReader() = default;
+
+void StreamReader::feed(char const* data, size_t size) {
+  if (size == 0)
+    return;
+  memcpy(prepare(size), data, size);
+  commit(size);
+}
+
+char* StreamReader::prepare(size_t size) {
+  if (capacity_ - end_ >= size)
+    return buffer_.get() + end_;
+  // Drop the lines already returned before growing.
+  size_t const pending = end_ - begin_;
+  if (begin_ != 0) {
+    memmove(buffer_.get(), buffer_.get() + begin_, pending);
+    scanned_ -= begin_;
+    end_ = pending;
+    begin_ = 0;
+  }
+  if (capacity_ - end_ < size) {
+    size_t const capacity = std::max(capacity_ * 2, end_ + size);
+    std::unique_ptr<char[]> buffer(new char[capacity]);
+    if (end_ != 0)
+      memcpy(buffer.get(), buffer_.get(), end_);
+    buffer_ = std::move(buffer);
+    capacity_ = capacity;
+  }
+  return buffer_.get() + end_;
+}
+
+void StreamReader::commit(size_t size) {
+  JSON_ASSERT_MESSAGE(size <= capacity_ - end_,
+                      "in Json::StreamReader::commit(): more than prepared");
+  end_ += size;
+}
+
+void StreamReader::finish() { finished_ = true; }
+
+StreamReader::Result StreamReader::next(Value* root, String* errs) {
+  for (;;) {
+    char* const data = buffer_.get();
+    auto newline = static_cast<char*>(
+        scanned_ == end_ ? nullptr
+                         : memchr(data + scanned_, '\n', end_ - scanned_));
+    size_t lineEnd = end_;
+    if (newline) {
+      lineEnd = static_cast<size_t>(newline - data);
+    } else if (!finished_ || begin_ == end_) {
+      scanned_ = end_;
+      // Start over at the front once everything has been returned.
+      if (begin_ == end_)
+        begin_ = scanned_ = end_ = 0;
+      return needMoreInput;
+    }
+    char const* begin = data + begin_;
+    char const* end = data + lineEnd;
+    begin_ = scanned_ = newline ? lineEnd + 1 : lineEnd;
+    if (std::all_of(begin, end, [](char c) {
+          return c == ' ' || c == '\t' || c == '\r';
+        }))
+      continue;
+    if (errs)
+      errs->clear();
+    return reader_->parse(begin, end, root, errs) ? document : invalidDocument;
+  }
+}
+
 IStream& operator>>(IStream& sin, Value& root) {
   CharReaderBuilder b;
   String errs;
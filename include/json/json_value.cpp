@@ -128,28 +128,38 @@ static inline char* duplicateStringValue(const char* value, size_t length) {
   return newString;
 }
 
-/* Record the length as a prefix.
+/* Write the length prefix, the characters and a terminating zero into a
+ * buffer of prefixedStringSize(length) bytes.
  */
-static inline char* duplicateAndPrefixStringValue(const char* value,
-                                                  unsigned int length) {
+static inline size_t prefixedStringSize(unsigned int length) {
   // Avoid an integer overflow in the call to malloc below by limiting length
   // to a sane value.
   JSON_ASSERT_MESSAGE(length <= static_cast<unsigned>(Value::maxInt) -
                                     sizeof(unsigned) - 1U,
                       "in Json::Value::duplicateAndPrefixStringValue(): "
                       "length too big for prefixing");
-  size_t actualLength = sizeof(length) + length + 1;
-  auto newString = static_cast<char*>(malloc(actualLength));
-  if (newString == nullptr) {
-    throwRuntimeError("in Json::Value::duplicateAndPrefixStringValue(): "
-                      "Failed to allocate string value buffer");
-  }
+  return sizeof(length) + length + 1;
+}
+static inline char* prefixStringValue(char* newString, const char* value,
+                                      unsigned int length) {
   *reinterpret_cast<unsigned*>(newString) = length;
   memcpy(newString + sizeof(unsigned), value, length);
-  newString[actualLength - 1U] =
+  newString[sizeof(unsigned) + length] =
       0; // to avoid buffer over-run accidents by users later
   return newString;
 }
+
+/* Record the length as a prefix.
+ */
+static inline char* duplicateAndPrefixStringValue(const char* value,
+                                                  unsigned int length) {
+  auto newString = static_cast<char*>(malloc(prefixedStringSize(length)));
+  if (newString == nullptr) {
+    throwRuntimeError("in Json::Value::duplicateAndPrefixStringValue(): "
+                      "Failed to allocate string value buffer");
+  }
+  return prefixStringValue(newString, value, length);
+}
 inline static void decodePrefixedString(bool isPrefixed, char const* prefixed,
                                         unsigned* length, char const** value) {
   if (!isPrefixed) {
@@ -183,6 +193,144 @@ static inline void releasePrefixedStringValue(char* value) { free(value); }
 static inline void releaseStringValue(char* value, unsigned) { free(value); }
 #endif // JSONCPP_USING_SECURE_MEMORY
 
+#if JSON_USE_VALUE_ARENA
+/* Maps are placed in the current arena together with their nodes; only the
+ * destructor runs when they are released.
+ */
+static inline Value::ObjectValues* newObjectValues() {
+  if (ValueArena* arena = ValueArena::current())
+    return new (arena->allocate(sizeof(Value::ObjectValues),
+                                alignof(Value::ObjectValues)))
+        Value::ObjectValues();
+  return new Value::ObjectValues();
+}
+static inline Value::ObjectValues*
+newObjectValues(const Value::ObjectValues& other) {
+  if (ValueArena* arena = ValueArena::current())
+    return new (arena->allocate(sizeof(Value::ObjectValues),
+                                alignof(Value::ObjectValues)))
+        Value::ObjectValues(other);
+  return new Value::ObjectValues(other);
+}
+static inline void deleteObjectValues(Value::ObjectValues* map) {
+  using ObjectValues = Value::ObjectValues;
+  if (map->get_allocator().arena())
+    map->~ObjectValues();
+  else
+    delete map;
+}
+
+/* Members added while an arena is current have their keys and strings in
+ * that arena, so the map they go into must not outlive it.
+ */
+static inline void checkObjectValuesArena(const Value::ObjectValues& map) {
+  JSON_ASSERT_MESSAGE(!ValueArena::current() ||
+                          map.get_allocator().arena() == ValueArena::current(),
+                      "a member was added to a container of another arena "
+                      "while a ValueArena is current");
+  (void)map;
+}
+
+/* Returns a copy of a key in the current arena, or nullptr when there is no
+ * current arena.
+ */
+static inline char* duplicateKeyInArena(const char* value, unsigned length) {
+  if (ValueArena* arena = ValueArena::current()) {
+    auto key = static_cast<char*>(arena->allocate(length + 1U, 1));
+    memcpy(key, value, length);
+    key[length] = 0;
+    return key;
+  }
+  return nullptr;
+}
+
+/* Returns a prefixed copy of a string in the current arena, or nullptr when
+ * there is no current arena.
+ */
+static inline char* duplicateAndPrefixStringInArena(const char* value,
+                                                    unsigned length) {
+  if (ValueArena* arena = ValueArena::current())
+    return prefixStringValue(
+        static_cast<char*>(
+            arena->allocate(prefixedStringSize(length), alignof(unsigned))),
+        value, length);
+  return nullptr;
+}
+#else
+static inline Value::ObjectValues* newObjectValues() {
+  return new Value::ObjectValues();
+}
+static inline Value::ObjectValues*
+newObjectValues(const Value::ObjectValues& other) {
+  return new Value::ObjectValues(other);
+}
+static inline void deleteObjectValues(Value::ObjectValues* map) { delete map; }
+static inline void checkObjectValuesArena(const Value::ObjectValues&) {}
+static inline char* duplicateKeyInArena(const char*, unsigned) {
+  return nullptr;
+}
+static inline char* duplicateAndPrefixStringInArena(const char*, unsigned) {
+  return nullptr;
+}
+#endif // if JSON_USE_VALUE_ARENA
+
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// class ValueArena
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+
+#if JSON_USE_VALUE_ARENA
+static thread_local ValueArena* currentArena = nullptr;
+
+ValueArena::ValueArena(size_t blockSize) : blockSize_(blockSize) {}
+
+ValueArena::~ValueArena() {
+  while (head_) {
+    Block* next = head_->next_;
+    ::operator delete(head_);
+    head_ = next;
+  }
+}
+
+void* ValueArena::allocate(size_t size, size_t alignment) {
+  auto cursor = reinterpret_cast<uintptr_t>(cursor_);
+  uintptr_t aligned = (cursor + alignment - 1) & ~(uintptr_t(alignment) - 1);
+  if (!cursor_ || aligned + size > reinterpret_cast<uintptr_t>(end_)) {
+    // Oversized requests get a block of their own so the current block
+    // keeps serving small ones.
+    size_t const header = (sizeof(Block) + alignment - 1) & ~(alignment - 1);
+    size_t const blockSize = std::max(blockSize_, header + size);
+    auto block = static_cast<Block*>(::operator new(blockSize));
+    block->size_ = blockSize;
+    reserved_ += blockSize;
+    char* payload = reinterpret_cast<char*>(block) + header;
+    if (blockSize > blockSize_ && head_) {
+      block->next_ = head_->next_;
+      head_->next_ = block;
+      return payload;
+    }
+    block->next_ = head_;
+    head_ = block;
+    cursor_ = payload;
+    end_ = reinterpret_cast<char*>(block) + blockSize;
+    aligned = reinterpret_cast<uintptr_t>(cursor_);
+  }
+  cursor_ = reinterpret_cast<char*>(aligned + size);
+  return reinterpret_cast<void*>(aligned);
+}
+
+ValueArena* ValueArena::current() { return currentArena; }
+
+ValueArena::Scope::Scope(ValueArena& arena) : previous_(currentArena) {
+  currentArena = &arena;
+}
+
+ValueArena::Scope::~Scope() { currentArena = previous_; }
+#endif // if JSON_USE_VALUE_ARENA
+
 } // namespace Json
 
 // //////////////////////////////////////////////////////////////////
@@ -244,16 +392,23 @@ Value::CZString::CZString(char const* str, unsigned length,
 }
 
 Value::CZString::CZString(const CZString& other) {
-  cstr_ = (other.storage_.policy_ != noDuplication && other.cstr_ != nullptr
-               ? duplicateStringValue(other.cstr_, other.storage_.length_)
-               : other.cstr_);
+  bool inArena = false;
+  if (other.storage_.policy_ != noDuplication && other.cstr_ != nullptr) {
+    unsigned const length = other.storage_.length_;
+    cstr_ = duplicateKeyInArena(other.cstr_, length);
+    inArena = cstr_ != nullptr;
+    if (!inArena)
+      cstr_ = duplicateStringValue(other.cstr_, length);
+  } else {
+    cstr_ = other.cstr_;
+  }
   storage_.policy_ =
       static_cast<unsigned>(
           other.cstr_
               ? (static_cast<DuplicationPolicy>(other.storage_.policy_) ==
                          noDuplication
                      ? noDuplication
-                     : duplicate)
+                     : (inArena ? duplicateInArena : duplicate))
               : static_cast<DuplicationPolicy>(other.storage_.policy_)) &
       3U;
   storage_.length_ = other.storage_.length_;
@@ -363,7 +518,7 @@ Value::Value(ValueType type) {
     break;
   case arrayValue:
   case objectValue:
-    value_.map_ = new ObjectValues();
+    value_.map_ = newObjectValues();
     break;
   case booleanValue:
     value_.bool_ = false;
@@ -399,23 +554,20 @@ Value::Value(double value) {
 }
 
 Value::Value(const char* value) {
-  initBasic(stringValue, true);
+  initBasic(stringValue);
   JSON_ASSERT_MESSAGE(value != nullptr,
                       "Null Value Passed to Value Constructor");
-  value_.string_ = duplicateAndPrefixStringValue(
-      value, static_cast<unsigned>(strlen(value)));
+  dupString(value, static_cast<unsigned>(strlen(value)));
 }
 
 Value::Value(const char* begin, const char* end) {
-  initBasic(stringValue, true);
-  value_.string_ =
-      duplicateAndPrefixStringValue(begin, static_cast<unsigned>(end - begin));
+  initBasic(stringValue);
+  dupString(begin, static_cast<unsigned>(end - begin));
 }
 
 Value::Value(const String& value) {
-  initBasic(stringValue, true);
-  value_.string_ = duplicateAndPrefixStringValue(
-      value.data(), static_cast<unsigned>(value.length()));
+  initBasic(stringValue);
+  dupString(value.data(), static_cast<unsigned>(value.length()));
 }
 
 Value::Value(const StaticString& value) {
@@ -423,6 +575,13 @@ Value::Value(const StaticString& value) {
   value_.string_ = const_cast<char*>(value.c_str());
 }
 
+Value::Value(const BorrowedString& value) {
+  initBasic(stringValue);
+  bits_.borrowed_ = true;
+  bits_.length_ = static_cast<unsigned>(value.end() - value.begin());
+  value_.string_ = const_cast<char*>(value.begin());
+}
+
 Value::Value(bool value) {
   initBasic(booleanValue);
   value_.bool_ = value;
@@ -503,17 +662,15 @@ bool Value::operator<(const Value& other) const {
   case booleanValue:
     return value_.bool_ < other.value_.bool_;
   case stringValue: {
-    if ((value_.string_ == nullptr) || (other.value_.string_ == nullptr)) {
-      return other.value_.string_ != nullptr;
+    if (!hasString() || !other.hasString()) {
+      return other.hasString();
     }
     unsigned this_len;
     unsigned other_len;
     char const* this_str;
     char const* other_str;
-    decodePrefixedString(this->isAllocated(), this->value_.string_, &this_len,
-                         &this_str);
-    decodePrefixedString(other.isAllocated(), other.value_.string_, &other_len,
-                         &other_str);
+    this->decodeString(&this_len, &this_str);
+    other.decodeString(&other_len, &other_str);
     unsigned min_len = std::min<unsigned>(this_len, other_len);
     JSON_ASSERT(this_str && other_str);
     int comp = memcmp(this_str, other_str, min_len);
@@ -558,17 +715,15 @@ bool Value::operator==(const Value& other) const {
   case booleanValue:
     return value_.bool_ == other.value_.bool_;
   case stringValue: {
-    if ((value_.string_ == nullptr) || (other.value_.string_ == nullptr)) {
-      return (value_.string_ == other.value_.string_);
+    if (!hasString() || !other.hasString()) {
+      return hasString() == other.hasString();
     }
     unsigned this_len;
     unsigned other_len;
     char const* this_str;
     char const* other_str;
-    decodePrefixedString(this->isAllocated(), this->value_.string_, &this_len,
-                         &this_str);
-    decodePrefixedString(other.isAllocated(), other.value_.string_, &other_len,
-                         &other_str);
+    this->decodeString(&this_len, &this_str);
+    other.decodeString(&other_len, &other_str);
     if (this_len != other_len)
       return false;
     JSON_ASSERT(this_str && other_str);
@@ -590,12 +745,11 @@ bool Value::operator!=(const Value& other) const { return !(*this == other); }
 const char* Value::asCString() const {
   JSON_ASSERT_MESSAGE(type() == stringValue,
                       "in Json::Value::asCString(): requires stringValue");
-  if (value_.string_ == nullptr)
+  if (!hasString())
     return nullptr;
   unsigned this_len;
   char const* this_str;
-  decodePrefixedString(this->isAllocated(), this->value_.string_, &this_len,
-                       &this_str);
+  this->decodeString(&this_len, &this_str);
   return this_str;
 }
 
@@ -603,12 +757,11 @@ const char* Value::asCString() const {
 unsigned Value::getCStringLength() const {
   JSON_ASSERT_MESSAGE(type() == stringValue,
                       "in Json::Value::asCString(): requires stringValue");
-  if (value_.string_ == 0)
+  if (!hasString())
     return 0;
   unsigned this_len;
   char const* this_str;
-  decodePrefixedString(this->isAllocated(), this->value_.string_, &this_len,
-                       &this_str);
+  this->decodeString(&this_len, &this_str);
   return this_len;
 }
 #endif
@@ -616,11 +769,10 @@ unsigned Value::getCStringLength() const {
 bool Value::getString(char const** begin, char const** end) const {
   if (type() != stringValue)
     return false;
-  if (value_.string_ == nullptr)
+  if (!hasString())
     return false;
   unsigned length;
-  decodePrefixedString(this->isAllocated(), this->value_.string_, &length,
-                       begin);
+  this->decodeString(&length, begin);
   *end = *begin + length;
   return true;
 }
@@ -630,12 +782,11 @@ String Value::asString() const {
   case nullValue:
     return "";
   case stringValue: {
-    if (value_.string_ == nullptr)
+    if (!hasString())
       return "";
     unsigned this_len;
     char const* this_str;
-    decodePrefixedString(this->isAllocated(), this->value_.string_, &this_len,
-                         &this_str);
+    this->decodeString(&this_len, &this_str);
     return String(this_str, this_len);
   }
   case booleanValue:
@@ -933,6 +1084,7 @@ Value& Value::operator[](ArrayIndex index) {
   if (it != value_.map_->end() && (*it).first == key)
     return (*it).second;
 
+  checkObjectValuesArena(*value_.map_);
   ObjectValues::value_type defaultValue(key, nullSingleton());
   it = value_.map_->insert(it, defaultValue);
   return (*it).second;
@@ -968,14 +1120,62 @@ const Value& Value::operator[](int index) const {
 void Value::initBasic(ValueType type, bool allocated) {
   setType(type);
   setIsAllocated(allocated);
+  bits_.borrowed_ = false;
+  bits_.arena_ = false;
+  bits_.inline_ = false;
+  bits_.length_ = 0;
   comments_ = Comments{};
   start_ = 0;
   limit_ = 0;
 }
 
+void Value::decodeString(unsigned* length, char const** value) const {
+  if (bits_.inline_) {
+    *length = bits_.inlineLength_;
+    *value = inlineString();
+  } else if (bits_.borrowed_) {
+    *length = bits_.length_;
+    *value = value_.string_;
+  } else {
+    decodePrefixedString(isAllocated() || bits_.arena_, value_.string_, length,
+                         value);
+  }
+}
+
+void Value::dupString(char const* value, unsigned length) {
+  static_assert(sizeof(value_) == 8 && sizeof(bits_) == 8,
+                "inline strings rely on value_ and bits_ being 8 bytes each");
+  static_assert(offsetof(Value, bits_) ==
+                    offsetof(Value, value_) + sizeof(value_),
+                "inline strings rely on value_ and bits_ being adjacent");
+  static_assert(offsetof(Value, bits_.value_type_) ==
+                    offsetof(Value, bits_) + sizeof(bits_.length_) +
+                        sizeof(bits_.tail_),
+                "inline strings must end right before value_type_");
+  // Everything up to value_type_, less the terminating zero.
+  unsigned const maxInlineLength =
+      sizeof(value_) + sizeof(bits_.length_) + sizeof(bits_.tail_) - 1;
+  if (length <= maxInlineLength) {
+    memcpy(inlineString(), value, length);
+    inlineString()[length] = 0;
+    bits_.inline_ = true;
+    bits_.inlineLength_ = length & 0xF;
+  } else if (char* string = duplicateAndPrefixStringInArena(value, length)) {
+    value_.string_ = string;
+    bits_.arena_ = true;
+  } else {
+    value_.string_ = duplicateAndPrefixStringValue(value, length);
+    setIsAllocated(true);
+  }
+}
+
 void Value::dupPayload(const Value& other) {
   setType(other.type());
   setIsAllocated(false);
+  bits_.borrowed_ = other.bits_.borrowed_;
+  bits_.arena_ = false;
+  bits_.inline_ = false;
+  bits_.length_ = other.bits_.length_;
   switch (type()) {
   case nullValue:
   case intValue:
@@ -985,20 +1185,22 @@ void Value::dupPayload(const Value& other) {
     value_ = other.value_;
     break;
   case stringValue:
-    if (other.value_.string_ && other.isAllocated()) {
+    if (other.bits_.inline_) {
+      value_ = other.value_;
+      bits_ = other.bits_;
+    } else if (other.value_.string_ &&
+               (other.isAllocated() || other.bits_.arena_)) {
       unsigned len;
       char const* str;
-      decodePrefixedString(other.isAllocated(), other.value_.string_, &len,
-                           &str);
-      value_.string_ = duplicateAndPrefixStringValue(str, len);
-      setIsAllocated(true);
+      other.decodeString(&len, &str);
+      dupString(str, len);
     } else {
       value_.string_ = other.value_.string_;
     }
     break;
   case arrayValue:
   case objectValue:
-    value_.map_ = new ObjectValues(*other.value_.map_);
+    value_.map_ = newObjectValues(*other.value_.map_);
     break;
   default:
     JSON_ASSERT_UNREACHABLE;
@@ -1019,7 +1221,7 @@ void Value::releasePayload() {
     break;
   case arrayValue:
   case objectValue:
-    delete value_.map_;
+    deleteObjectValues(value_.map_);
     break;
   default:
     JSON_ASSERT_UNREACHABLE;
@@ -1047,6 +1249,7 @@ Value& Value::resolveReference(const char* key) {
   if (it != value_.map_->end() && (*it).first == actualKey)
     return (*it).second;
 
+  checkObjectValuesArena(*value_.map_);
   ObjectValues::value_type defaultValue(actualKey, nullSingleton());
   it = value_.map_->insert(it, defaultValue);
   Value& value = (*it).second;
@@ -1066,6 +1269,7 @@ Value& Value::resolveReference(char const* key, char const* end) {
   if (it != value_.map_->end() && (*it).first == actualKey)
     return (*it).second;
 
+  checkObjectValuesArena(*value_.map_);
   ObjectValues::value_type defaultValue(actualKey, nullSingleton());
   it = value_.map_->insert(it, defaultValue);
   Value& value = (*it).second;
@@ -1131,6 +1335,7 @@ Value& Value::append(Value&& value) {
   if (type() == nullValue) {
     *this = Value(arrayValue);
   }
+  checkObjectValuesArena(*value_.map_);
   return this->value_.map_->emplace(size(), std::move(value)).first->second;
 }
 
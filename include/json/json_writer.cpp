@@ -10,6 +10,11 @@
 #include <algorithm>
 #include <cassert>
 #include <cctype>
+#if defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
 #include <cstring>
 #include <iomanip>
 #include <memory>
@@ -272,19 +277,22 @@ static void appendHex(String& result, unsigned ch) {
   result.append("\\u").append(toHex16Bit(ch));
 }
 
-static String valueToQuotedStringN(const char* value, size_t length,
-                                   bool emitUTF8 = false) {
+static void appendQuotedStringN(String& result, const char* value,
+                                size_t length, bool emitUTF8 = false) {
   if (value == nullptr)
-    return "";
+    return;
 
-  if (!doesAnyCharRequireEscaping(value, length))
-    return String("\"") + value + "\"";
+  if (!doesAnyCharRequireEscaping(value, length)) {
+    result += '"';
+    result.append(value, length);
+    result += '"';
+    return;
+  }
   // We have to walk value and escape any special characters.
   // Appending to String is not efficient, but this should be rare.
   // (Note: forward slashes are *not* rare, but I am not escaping them.)
   String::size_type maxsize = length * 2 + 3; // allescaped+quotes+NULL
-  String result;
-  result.reserve(maxsize); // to avoid lots of mallocs
+  result.reserve(result.size() + maxsize); // to avoid lots of mallocs
   result += "\"";
   char const* end = value + length;
   for (const char* c = value; c != end; ++c) {
@@ -346,6 +354,12 @@ static String valueToQuotedStringN(const char* value, size_t length,
     }
   }
   result += "\"";
+}
+
+static String valueToQuotedStringN(const char* value, size_t length,
+                                   bool emitUTF8 = false) {
+  String result;
+  appendQuotedStringN(result, value, length, emitUTF8);
   return result;
 }
 
@@ -431,6 +445,142 @@ void FastWriter::writeValue(const Value& value) {
   }
 }
 
+// Class BufferWriter
+// //////////////////////////////////////////////////////////////////
+
+static const char digits2[] = "00010203040506070809"
+                              "10111213141516171819"
+                              "20212223242526272829"
+                              "30313233343536373839"
+                              "40414243444546474849"
+                              "50515253545556575859"
+                              "60616263646566676869"
+                              "70717273747576777879"
+                              "80818283848586878889"
+                              "90919293949596979899";
+
+static void appendUInt(String& buffer, LargestUInt value, bool negative) {
+  UIntToStringBuffer digits;
+  char* current = digits + sizeof(digits);
+  while (value >= 100) {
+    auto const pair = static_cast<unsigned>(value % 100) * 2;
+    value /= 100;
+    *--current = digits2[pair + 1];
+    *--current = digits2[pair];
+  }
+  if (value >= 10) {
+    auto const pair = static_cast<unsigned>(value) * 2;
+    *--current = digits2[pair + 1];
+    *--current = digits2[pair];
+  } else {
+    *--current = static_cast<char>('0' + value);
+  }
+  if (negative)
+    *--current = '-';
+  buffer.append(current, static_cast<size_t>(digits + sizeof(digits) - current));
+}
+
+static void appendReal(String& buffer, double value, bool useSpecialFloats) {
+  if (!isfinite(value)) {
+    static const char* const reps[2][3] = {{"NaN", "-Infinity", "Infinity"},
+                                           {"null", "-1e+9999", "1e+9999"}};
+    buffer += reps[useSpecialFloats ? 0 : 1]
+                  [isnan(value) ? 0 : (value < 0) ? 1 : 2];
+    return;
+  }
+  char digits[32];
+#if defined(__cpp_lib_to_chars)
+  // Shortest representation that reads back as the same double.
+  char* end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+#else
+  int len = jsoncpp_snprintf(digits, sizeof(digits), "%.17g", value);
+  char* end = fixNumericLocale(digits, digits + len);
+#endif
+  buffer.append(digits, static_cast<size_t>(end - digits));
+  // Keep the value recognisable as a real, as valueToString() does.
+  if (std::none_of(digits, end, [](char c) { return c == '.' || c == 'e'; }))
+    buffer += ".0";
+}
+
+BufferWriter::BufferWriter() = default;
+
+void BufferWriter::useSpecialFloats(bool enable) { useSpecialFloats_ = enable; }
+
+void BufferWriter::emitUTF8(bool enable) { emitUTF8_ = enable; }
+
+void BufferWriter::write(const Value& root, String& buffer) const {
+  writeValue(root, buffer);
+}
+
+String BufferWriter::write(const Value& root) const {
+  String buffer;
+  writeValue(root, buffer);
+  return buffer;
+}
+
+void BufferWriter::writeValue(const Value& value, String& buffer) const {
+  switch (value.type()) {
+  case nullValue:
+    buffer += "null";
+    break;
+  case intValue: {
+    LargestInt const i = value.asLargestInt();
+    // Negate in unsigned arithmetic so minLargestInt does not overflow.
+    appendUInt(buffer, i < 0 ? 0 - LargestUInt(i) : LargestUInt(i), i < 0);
+    break;
+  }
+  case uintValue:
+    appendUInt(buffer, value.asLargestUInt(), false);
+    break;
+  case realValue:
+    appendReal(buffer, value.asDouble(), useSpecialFloats_);
+    break;
+  case stringValue: {
+    char const* str;
+    char const* end;
+    if (value.getString(&str, &end))
+      appendQuotedStringN(buffer, str, static_cast<size_t>(end - str),
+                          emitUTF8_);
+    break;
+  }
+  case booleanValue:
+    buffer += value.asBool() ? "true" : "false";
+    break;
+  case arrayValue: {
+    buffer += '[';
+    // Elements are kept in index order, so iterate rather than look each one
+    // up. Arrays may have holes (e.g. after `a[3] = 1`); like FastWriter,
+    // write those as null. size() is the last index plus one, so there are
+    // no trailing holes.
+    ArrayIndex next = 0;
+    for (auto it = value.begin(); it != value.end(); ++it) {
+      ArrayIndex const index = it.index();
+      for (; next < index; ++next)
+        buffer += next ? ",null" : "null";
+      if (next)
+        buffer += ',';
+      writeValue(*it, buffer);
+      next = index + 1;
+    }
+    buffer += ']';
+  } break;
+  case objectValue: {
+    buffer += '{';
+    for (auto it = value.begin(); it != value.end(); ++it) {
+      if (it != value.begin())
+        buffer += ',';
+      char const* end;
+      char const* name = it.memberName(&end);
+      appendQuotedStringN(buffer, name, static_cast<size_t>(end - name),
+                          emitUTF8_);
+      buffer += ':';
+      writeValue(*it, buffer);
+    }
+    buffer += '}';
+  } break;
+  }
+}
+
 // Class StyledWriter
 // //////////////////////////////////////////////////////////////////
 
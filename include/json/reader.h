@@ -239,6 +239,34 @@ private:
   bool collectComments_{};
 }; // Reader
 
+/** \brief Receives the events of a streaming parse.
+ *
+ * Used with CharReader::parseEvents() to consume a
+ * document without building a Value tree. Keys and strings are passed as
+ * [begin, end) ranges that are only valid during the call; strings without
+ * escape sequences point directly into the document. Return false from any
+ * callback to stop parsing.
+ */
+class JSON_API ParseHandler {
+public:
+  virtual ~ParseHandler() = default;
+  virtual bool onNull() { return true; }
+  virtual bool onBool(bool /*value*/) { return true; }
+  virtual bool onInt(LargestInt /*value*/) { return true; }
+  virtual bool onUInt(LargestUInt /*value*/) { return true; }
+  virtual bool onDouble(double /*value*/) { return true; }
+  virtual bool onString(char const* /*begin*/, char const* /*end*/) {
+    return true;
+  }
+  virtual bool onObjectBegin() { return true; }
+  virtual bool onKey(char const* /*begin*/, char const* /*end*/) {
+    return true;
+  }
+  virtual bool onObjectEnd() { return true; }
+  virtual bool onArrayBegin() { return true; }
+  virtual bool onArrayEnd() { return true; }
+};
+
 /** Interface for reading JSON from a char array.
  */
 class JSON_API CharReader {
@@ -263,6 +291,30 @@ public:
   virtual bool parse(char const* beginDoc, char const* endDoc, Value* root,
                      String* errs) = 0;
 
+  /** \brief Read a Value from a <a HREF="http://www.json.org">JSON</a>
+   * document, decoding strings inside the document itself.
+   *
+   * String values are unescaped and null-terminated in place, and \p root
+   * refers to them as BorrowedString instead of copying them. The document is
+   * modified and must outlive \p root and every copy of it. Member names are
+   * still copied. The default implementation behaves like parse().
+   */
+  virtual bool parseInSitu(char* beginDoc, char* endDoc, Value* root,
+                           String* errs);
+
+  /** \brief Read a <a HREF="http://www.json.org">JSON</a> document and report
+   * it to \p handler as a sequence of events.
+   *
+   * The default implementation parses into a Value and replays it; readers
+   * created by CharReaderBuilder stream the events without building a Value.
+   * Comments are never reported.
+   *
+   * \return \c true if the document was successfully parsed, \c false if an
+   * error occurred or the handler stopped the parse.
+   */
+  virtual bool parseEvents(char const* beginDoc, char const* endDoc,
+                           ParseHandler& handler, String* errs);
+
   class JSON_API Factory {
   public:
     virtual ~Factory() = default;
@@ -368,6 +420,73 @@ public:
 bool JSON_API parseFromStream(CharReader::Factory const&, IStream&, Value* root,
                               String* errs);
 
+/** \brief Reads newline-delimited JSON (NDJSON) as it arrives.
+ *
+ * Input is appended in chunks of any size, and next() yields one document
+ * per complete line. Blank lines are skipped. The CharReader and the input
+ * buffer are kept for the whole stream, so a long-lived StreamReader stops
+ * allocating once it has buffered its longest line.
+ *
+ * Reading a pipe without an intermediate copy:
+ *   \code
+ *   Json::StreamReader stream;
+ *   Json::Value event;
+ *   Json::String errs;
+ *   for (;;) {
+ *     ssize_t n = read(fd, stream.prepare(65536), 65536);
+ *     if (n <= 0)
+ *       stream.finish();
+ *     else
+ *       stream.commit(size_t(n));
+ *     while (auto result = stream.next(&event, &errs)) {
+ *       if (result == Json::StreamReader::document)
+ *         handle(event);
+ *     }
+ *     if (n <= 0)
+ *       break;
+ *   }
+ *   \endcode
+ */
+class JSON_API StreamReader {
+public:
+  enum Result {
+    needMoreInput = 0, ///< No complete line is buffered.
+    document,          ///< root holds the next document.
+    invalidDocument    ///< The line was skipped; errs says why.
+  };
+
+  /// Parses with the defaults of CharReaderBuilder.
+  StreamReader();
+  explicit StreamReader(CharReader::Factory const& factory);
+  StreamReader(StreamReader const&) = delete;
+  StreamReader& operator=(StreamReader const&) = delete;
+  ~StreamReader();
+
+  /// Appends a chunk of input.
+  void feed(char const* data, size_t size);
+  /** \brief Returns room for at least \p size more bytes of input.
+   *
+   * Write into it, then call commit() with the number of bytes written. The
+   * pointer is valid until the next call that modifies the StreamReader.
+   */
+  char* prepare(size_t size);
+  void commit(size_t size);
+  /// Marks the end of input, so a last line without a newline is parsed too.
+  void finish();
+
+  /// Parses the next complete line into \p root.
+  Result next(Value* root, String* errs);
+
+private:
+  std::unique_ptr<CharReader> reader_;
+  std::unique_ptr<char[]> buffer_;
+  size_t capacity_{0};
+  size_t begin_{0};   // first byte not yet returned
+  size_t scanned_{0}; // no newline in [begin_, scanned_)
+  size_t end_{0};     // end of the input received so far
+  bool finished_{false};
+};
+
 /** \brief Read from 'sin' into 'root'.
  *
  * Always keep comments from the input JSON.
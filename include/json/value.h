@@ -39,6 +39,7 @@
 #endif
 #endif
 
+#include <algorithm>
 #include <array>
 #include <exception>
 #include <map>
@@ -156,6 +157,142 @@ private:
   const char* c_str_;
 };
 
+/** \brief Lightweight wrapper to tag a string that a Value may refer to
+ * without copying.
+ *
+ * The characters need not be null-terminated. They must stay alive and
+ * unchanged for as long as the Value, or any copy of it, exists; copies refer
+ * to the same characters. Used by CharReader::parseInSitu().
+ */
+class JSON_API BorrowedString {
+public:
+  BorrowedString(const char* begin, const char* end)
+      : begin_(begin), end_(end) {}
+
+  const char* begin() const { return begin_; }
+  const char* end() const { return end_; }
+
+private:
+  const char* begin_;
+  const char* end_;
+};
+
+#if JSON_USE_FLAT_OBJECT_VALUES
+/** \brief Sorted vector with the subset of the std::map interface used by
+ * Value to store object and array members.
+ *
+ * Tiny containers are searched linearly. Appending in key order, as arrays
+ * and most parsed documents do, does not move existing members.
+ */
+template <typename Key, typename T, typename Allocator> class FlatMap {
+public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<Key, T>;
+  using allocator_type = Allocator;
+  using size_type = std::size_t;
+  using iterator = typename std::vector<value_type, Allocator>::iterator;
+  using const_iterator =
+      typename std::vector<value_type, Allocator>::const_iterator;
+
+  /// Containers up to this size are searched front to back.
+  static constexpr size_type linearSearchLimit = 8;
+
+  allocator_type get_allocator() const { return members_.get_allocator(); }
+
+  iterator begin() { return members_.begin(); }
+  iterator end() { return members_.end(); }
+  const_iterator begin() const { return members_.begin(); }
+  const_iterator end() const { return members_.end(); }
+  size_type size() const { return members_.size(); }
+  bool empty() const { return members_.empty(); }
+  void clear() { members_.clear(); }
+
+  iterator lower_bound(const Key& key) {
+    return lowerBound(members_.begin(), members_.end(), key);
+  }
+  const_iterator lower_bound(const Key& key) const {
+    return lowerBound(members_.begin(), members_.end(), key);
+  }
+  iterator find(const Key& key) {
+    iterator it = lower_bound(key);
+    return it != end() && it->first == key ? it : end();
+  }
+  const_iterator find(const Key& key) const {
+    const_iterator it = lower_bound(key);
+    return it != end() && it->first == key ? it : end();
+  }
+
+  /// Inserts \c value unless its key exists; \c hint is only a guess.
+  iterator insert(const_iterator hint, const value_type& value) {
+    if ((hint == end() || value.first < hint->first) &&
+        (hint == begin() || (hint - 1)->first < value.first))
+      return members_.insert(hint, value);
+    iterator it = lower_bound(value.first);
+    if (it != end() && it->first == value.first)
+      return it;
+    return members_.insert(it, value);
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    value_type value(std::forward<Args>(args)...);
+    if (members_.empty() || members_.back().first < value.first) {
+      members_.push_back(std::move(value));
+      return {members_.end() - 1, true};
+    }
+    iterator it = lower_bound(value.first);
+    if (it != end() && it->first == value.first)
+      return {it, false};
+    return {members_.insert(it, std::move(value)), true};
+  }
+
+  T& operator[](const Key& key) {
+    iterator it = lower_bound(key);
+    if (it == end() || !(it->first == key))
+      it = members_.insert(it, value_type(key, T()));
+    return it->second;
+  }
+
+  iterator erase(const_iterator pos) {
+    // Rotate the member to the back so it is destroyed rather than
+    // overwritten by a move assignment.
+    iterator it = members_.begin() + (pos - members_.cbegin());
+    std::rotate(it, it + 1, members_.end());
+    members_.pop_back();
+    return it;
+  }
+  size_type erase(const Key& key) {
+    const_iterator it = find(key);
+    if (it == end())
+      return 0;
+    erase(it);
+    return 1;
+  }
+
+  friend bool operator==(const FlatMap& a, const FlatMap& b) {
+    return a.members_ == b.members_;
+  }
+  friend bool operator<(const FlatMap& a, const FlatMap& b) {
+    return a.members_ < b.members_;
+  }
+
+private:
+  template <typename It> static It lowerBound(It first, It last, const Key& key) {
+    if (static_cast<size_type>(last - first) <= linearSearchLimit) {
+      while (first != last && first->first < key)
+        ++first;
+      return first;
+    }
+    return std::lower_bound(
+        first, last, key,
+        [](const value_type& member, const Key& k) { return member.first < k; });
+  }
+
+  std::vector<value_type, Allocator> members_;
+};
+#endif // if JSON_USE_FLAT_OBJECT_VALUES
+
 /** \brief Represents a <a HREF="http://www.json.org">JSON</a> value.
  *
  * This class is a discriminated union wrapper that can represents a:
@@ -259,7 +396,12 @@ private:
 #ifndef JSONCPP_DOC_EXCLUDE_IMPLEMENTATION
   class CZString {
   public:
-    enum DuplicationPolicy { noDuplication = 0, duplicate, duplicateOnCopy };
+    enum DuplicationPolicy {
+      noDuplication = 0,
+      duplicate,
+      duplicateOnCopy,
+      duplicateInArena ///< Copied into a ValueArena, never freed.
+    };
     CZString(ArrayIndex index);
     CZString(char const* str, unsigned length, DuplicationPolicy allocate);
     CZString(CZString const& other);
@@ -292,7 +434,19 @@ private:
   };
 
 public:
+#if JSON_USE_FLAT_OBJECT_VALUES && JSON_USE_VALUE_ARENA
+  typedef FlatMap<CZString, Value, ArenaAllocator<std::pair<CZString, Value>>>
+      ObjectValues;
+#elif JSON_USE_FLAT_OBJECT_VALUES
+  typedef FlatMap<CZString, Value, std::allocator<std::pair<CZString, Value>>>
+      ObjectValues;
+#elif JSON_USE_VALUE_ARENA
+  typedef std::map<CZString, Value, std::less<CZString>,
+                   ArenaAllocator<std::pair<const CZString, Value>>>
+      ObjectValues;
+#else
   typedef std::map<CZString, Value> ObjectValues;
+#endif
 #endif // ifndef JSONCPP_DOC_EXCLUDE_IMPLEMENTATION
 
 public:
@@ -340,6 +494,11 @@ public:
    *   \endcode
    */
   Value(const StaticString& value);
+  /** \brief Constructs a value that refers to the characters instead of
+   * copying them.
+   * \sa BorrowedString
+   */
+  Value(const BorrowedString& value);
   Value(const String& value);
   Value(bool value);
   Value(std::nullptr_t ptr) = delete;
@@ -373,7 +532,12 @@ public:
   bool operator!=(const Value& other) const;
   int compare(const Value& other) const;
 
-  const char* asCString() const; ///< Embedded zeroes could cause you trouble!
+  /// Embedded zeroes could cause you trouble! A BorrowedString is only
+  /// null-terminated if its owner terminated it, as parseInSitu() does.
+  /// \warning Strings of up to 13 bytes are stored inside the Value, so the
+  /// returned pointer is invalidated when the Value is moved, swapped or
+  /// destroyed, not only when it is modified.
+  const char* asCString() const;
 #if JSONCPP_USING_SECURE_MEMORY
   unsigned getCStringLength() const; // Allows you to understand the length of
                                      // the CString
@@ -381,6 +545,8 @@ public:
   String asString() const; ///< Embedded zeroes are possible.
   /** Get raw char* of string-value.
    *  \return false if !string. (Seg-fault if str or end are NULL.)
+   *  \warning As with asCString(), short strings live inside the Value and
+   *  the pointers are invalidated when it is moved or swapped.
    */
   bool getString(char const** begin, char const** end) const;
   Int asInt() const;
@@ -597,8 +763,17 @@ private:
   }
   bool isAllocated() const { return bits_.allocated_; }
   void setIsAllocated(bool v) { bits_.allocated_ = v; }
+  bool hasString() const { return bits_.inline_ || value_.string_ != nullptr; }
+  // The characters of an inline_ string start in value_ and run on into
+  // bits_, up to but excluding value_type_.
+  char* inlineString() { return reinterpret_cast<char*>(&value_); }
+  char const* inlineString() const {
+    return reinterpret_cast<char const*>(&value_);
+  }
 
   void initBasic(ValueType type, bool allocated = false);
+  void decodeString(unsigned* length, char const** value) const;
+  void dupString(char const* value, unsigned length);
   void dupPayload(const Value& other);
   void releasePayload();
   void dupMeta(const Value& other);
@@ -620,15 +795,28 @@ private:
     LargestUInt uint_;
     double real_;
     bool bool_;
-    char* string_; // if allocated_, ptr to { unsigned, char[] }.
+    char* string_; // if allocated_ or arena_, ptr to { unsigned, char[] }.
     ObjectValues* map_;
   } value_;
 
+  // The layout is fixed byte by byte so that short strings can be stored in
+  // value_ together with length_ and tail_; see inlineString().
   struct {
-    // Really a ValueType, but types should agree for bitfield packing.
-    unsigned int value_type_ : 8;
-    // Unless allocated_, string_ must be null-terminated.
-    unsigned int allocated_ : 1;
+    // string_ points to length_ characters owned by someone else. Also fills
+    // what would otherwise be padding, so Value does not grow.
+    unsigned int length_;
+    char tail_[2];
+    // Really a ValueType.
+    unsigned char value_type_;
+    // Unless allocated_, arena_, borrowed_ or inline_, string_ must be
+    // null-terminated.
+    unsigned char allocated_ : 1;
+    unsigned char borrowed_ : 1;
+    // string_ is prefixed like allocated_ but lives in a ValueArena.
+    unsigned char arena_ : 1;
+    // The null-terminated characters are stored in place.
+    unsigned char inline_ : 1;
+    unsigned char inlineLength_ : 4;
   } bits_;
 
   class Comments {
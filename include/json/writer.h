@@ -199,6 +199,46 @@ private:
 #pragma warning(pop)
 #endif
 
+/** \brief Appends a Value in <a HREF="http://www.json.org">JSON</a> format
+ * to a caller-provided buffer, without formatting or comments.
+ *
+ * Real values are written with the fewest digits that read back as the same
+ * double, and integers and strings are copied straight into the buffer
+ * without intermediate Strings. Reusing one buffer, cleared between calls,
+ * avoids allocating once it has grown to the size of a typical document.
+ *
+ * \code
+ * Json::BufferWriter writer;
+ * Json::String buffer;
+ * for (;;) {
+ *   buffer.clear();
+ *   writer.write(snapshot(), buffer);
+ *   send(buffer.data(), buffer.size());
+ * }
+ * \endcode
+ * \sa StreamWriterBuilder
+ */
+class JSON_API BufferWriter {
+public:
+  BufferWriter();
+
+  /// Write non-finite reals as NaN, Infinity and -Infinity instead of null
+  /// and +/-1e+9999, as the "useSpecialFloats" setting does.
+  void useSpecialFloats(bool enable);
+  /// Write UTF-8 strings as they are instead of escaping them.
+  void emitUTF8(bool enable);
+
+  /// Appends \c root to \c buffer; no line feed is added.
+  void write(const Value& root, String& buffer) const;
+  String write(const Value& root) const;
+
+private:
+  void writeValue(const Value& value, String& buffer) const;
+
+  bool useSpecialFloats_{false};
+  bool emitUTF8_{false};
+};
+
 /** \brief Writes a Value in <a HREF="http://www.json.org">JSON</a> format in a
  *human friendly way.
  *
@@ -26,7 +26,8 @@ int main() {
         "decr": "减少",
         "exit": "退出"
     })");
-    app->loadLanguage("en", R"({
+    // 英文只登记来源，第一次切换过去时才解析。
+    app->registerLanguage("en", R"({
         "main_title": "HTI Demonstration",
         "page1": "Page 1",
         "page2": "Page 2", 
@@ -74,12 +75,13 @@ int main() {
         });
 
     // 8. 线程安全演示 - 每秒更新计数
-    std::thread([app, countLabel]() {
-        for (int i = 0;; i++) {
+    // 工作线程直接写入可观察的值，不需要投递事件。
+    auto tick = std::make_shared<Observable<long>>(0);
+    page2->add<Label>("Tick: ")->bind(tick);
+    std::thread([tick]() {
+        for (long i = 0;; i++) {
             std::this_thread::sleep_for(std::chrono::seconds(1));
-            app->tryPostEvent(std::make_shared<LambdaEvent>([countLabel, i](Event*) {
-                countLabel->text("Tick: " + std::to_string(i));
-                }));
+            tick->store(i);
         }
         }).detach();
 
@@ -0,0 +1,177 @@
+// UTF-8 转换的测试
+// 对照 SSE2 快速路径与逐字节路径的结果，包括无效编码和跨 16 字节边界的截断。
+// 直接包含 chh.cpp，才能调用文件内的模板。
+// g++ -std=c++17 -I. -Iinclude tests/chh_utf8.cpp include/json/*.cpp -pthread
+// 再用 -DCHH_NO_SIMD 编译一次，其余的检查在逐字节路径上也要通过。
+#include "../chh.cpp"
+
+static int failures = 0;
+
+#define CHECK(expr) do { \
+    if (!(expr)) { \
+        std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #expr); \
+        failures++; \
+    } \
+} while (0)
+
+// 固定的种子，失败可以复现。
+static unsigned nextRandom() {
+    static unsigned state = 12345;
+    state = state * 1103515245u + 12345u;
+    return state >> 16;
+}
+
+// 解码失败时返回 false。
+template <typename Char, bool Simd>
+static bool decode(std::string_view input, std::basic_string<Char>& output) {
+    output.assign(input.size(), 0);
+    try {
+        output.resize(chh::decodeUtf8<Char, Simd>(input.data(), input.data() + input.size(), output.data()) - output.data());
+    }
+    catch (const std::runtime_error&) {
+        output.clear();
+        return false;
+    }
+    return true;
+}
+
+template <typename Char, bool Simd>
+static bool encode(std::basic_string_view<Char> input, std::string& output) {
+    output.assign(input.size() * 4, 0);
+    try {
+        output.resize(chh::encodeUtf8<Char, Simd>(input.data(), input.data() + input.size(), output.data()) - output.data());
+    }
+    catch (const std::runtime_error&) {
+        output.clear();
+        return false;
+    }
+    return true;
+}
+
+template <typename Char>
+static bool decodeAgrees(std::string_view input) {
+    std::basic_string<Char> scalar, simd;
+    const bool a = decode<Char, false>(input, scalar);
+    const bool b = decode<Char, true>(input, simd);
+    return a == b && scalar == simd;
+}
+
+template <typename Char>
+static bool encodeAgrees(std::basic_string_view<Char> input) {
+    std::string scalar, simd;
+    const bool a = encode<Char, false>(input, scalar);
+    const bool b = encode<Char, true>(input, simd);
+    return a == b && scalar == simd;
+}
+
+// 有效和无效的序列
+static const char* const sequences[] = {
+    "\xC3\xA9", "\xE4\xB8\xAD", "\xF0\x9F\x98\x80", "\xF4\x8F\xBF\xBF", "\xEF\xBF\xBD",
+    // 过长的编码
+    "\xC0\x80", "\xC1\xBF", "\xE0\x80\x80", "\xE0\x9F\xBF", "\xF0\x80\x80\x80", "\xF0\x8F\xBF\xBF",
+    // 代理项
+    "\xED\xA0\x80", "\xED\xBF\xBF",
+    // 超过 U+10FFFF
+    "\xF4\x90\x80\x80", "\xF5\x80\x80\x80", "\xFF",
+    // 截断和孤立的后续字节
+    "\xC3", "\xE4\xB8", "\xF0\x9F\x98", "\x80", "\xBF",
+};
+
+// 每个序列放在 ASCII 中的每个位置，缓冲区在每个长度处结束，截断的序列会落在 16 字节边界上。
+static void testDecoderAgrees() {
+    for (const char* sequence : sequences) {
+        const std::string_view bytes(sequence);
+        for (size_t length = 0; length <= 48; length++) {
+            for (size_t at = 0; at <= length; at++) {
+                std::string input(length, 'a');
+                input.insert(at, bytes);
+                CHECK(decodeAgrees<char16_t>(input));
+                CHECK(decodeAgrees<char32_t>(input));
+                CHECK(decodeAgrees<wchar_t>(input));
+                // 截掉末尾，序列可能只剩一半。
+                for (size_t cut = 1; cut < bytes.size() && cut <= at + bytes.size(); cut++) {
+                    const std::string_view truncated(input.data(), at + bytes.size() - cut);
+                    CHECK(decodeAgrees<char16_t>(truncated));
+                    CHECK(decodeAgrees<char32_t>(truncated));
+                }
+            }
+        }
+    }
+    for (int i = 0; i < 20000; i++) {
+        std::string input(nextRandom() % 64, 0);
+        for (auto& c : input) {
+            // 大部分是 ASCII，偶尔夹杂多字节序列的片段。
+            const unsigned r = nextRandom();
+            c = char(r % 8 ? r % 0x80 : 0x80 + r % 0x80);
+        }
+        CHECK(decodeAgrees<char16_t>(input));
+        CHECK(decodeAgrees<char32_t>(input));
+    }
+}
+
+static void testEncoderAgrees() {
+    const char32_t codes[] = { 0x41, 0x7F, 0x80, 0x7FF, 0x800, 0xD7FF, 0xD800, 0xDBFF, 0xDC00, 0xDFFF,
+        0xE000, 0xFFFD, 0xFFFF, 0x10000, 0x1F600, 0x10FFFF, 0x110000, 0xFFFFFFFF };
+    for (char32_t code : codes) {
+        for (size_t length = 0; length <= 24; length++) {
+            for (size_t at = 0; at <= length; at++) {
+                std::u32string u32(length, U'a');
+                u32.insert(at, 1, code);
+                CHECK(encodeAgrees<char32_t>(u32));
+                std::u16string u16(length, u'a');
+                if (code < 0x10000) u16.insert(at, 1, char16_t(code));
+                else if (code <= 0x10FFFF) {
+                    const char32_t c = code - 0x10000;
+                    u16.insert(at, { char16_t(0xD800 + (c >> 10)), char16_t(0xDC00 + (c & 0x3FF)) });
+                }
+                CHECK(encodeAgrees<char16_t>(u16));
+                // 不成对的代理项落在末尾。
+                u16.push_back(u'\xD83D');
+                CHECK(encodeAgrees<char16_t>(u16));
+            }
+        }
+    }
+}
+
+// 公开的函数
+static void testPublic() {
+    const std::string text = "plain ASCII that is longer than sixteen bytes, \xE4\xB8\xAD\xE6\x96\x87 and \xF0\x9F\x98\x80.";
+    CHECK(chh::toString(chh::toU16String(text)) == text);
+    CHECK(chh::toString(chh::toU32String(text)) == text);
+    CHECK(chh::toString(chh::toWString(text)) == text);
+
+    std::string appended;
+    for (char32_t code : chh::toU32String(text)) chh::appendUtf8(appended, code);
+    CHECK(appended == text);
+    bool thrown = false;
+    try {
+        chh::appendUtf8(appended, 0xD800);
+    }
+    catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    // nextUtf8 与解码器一致，无效的字节只前进一个字节。
+    std::u32string decoded;
+    for (size_t pos = 0; pos < text.size();) decoded += chh::nextUtf8(text, pos);
+    CHECK(decoded == chh::toU32String(text));
+    const std::string_view invalid("\xE4\xB8" "a\xC0\x80");
+    size_t pos = 0;
+    CHECK(chh::nextUtf8(invalid, pos) == 0xFFFD && pos == 1);
+    CHECK(chh::nextUtf8(invalid, pos) == 0xFFFD && pos == 2);
+    CHECK(chh::nextUtf8(invalid, pos) == U'a' && pos == 3);
+    CHECK(chh::nextUtf8(invalid, pos) == 0xFFFD && pos == 4);
+
+    CHECK(chh::displayWidth(std::string_view("ab")) == 2);
+    CHECK(chh::displayWidth(std::string_view("\xE4\xB8\xAD\xE6\x96\x87")) == 4);
+    CHECK(chh::displayWidth(std::string_view("e\xCC\x81")) == 1);
+}
+
+int main() {
+    testDecoderAgrees();
+    testEncoderAgrees();
+    testPublic();
+    if (failures) std::fprintf(stderr, "%d check(s) failed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,100 @@
+// 消息模板与语言加载的测试
+// g++ -std=c++17 -I. -Iinclude tests/i18n_format.cpp chh.cpp hti.*.cpp include/json/*.cpp -pthread
+#include "hti.hpp"
+
+using namespace hti::i18n;
+
+static int failures = 0;
+
+#define CHECK(expr) do { \
+    if (!(expr)) { \
+        std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #expr); \
+        failures++; \
+    } \
+} while (0)
+
+static std::string format(std::string_view pattern, std::initializer_list<Arg> args = {}) {
+    std::string output;
+    MessageFormat(pattern).format(output, args);
+    return output;
+}
+
+static bool throws(std::string_view pattern) {
+    try {
+        MessageFormat format(pattern);
+    }
+    catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+// 单引号转义
+static void testQuoting() {
+    CHECK(format("it''s {n}", { Arg("n", 3) }) == "it's 3");
+    CHECK(format("'{'n'}' = {n}", { Arg("n", 3) }) == "{n} = 3");
+    CHECK(format("'{n}' = {n}", { Arg("n", 3) }) == "{n} = 3");
+    CHECK(format("use '{}' for {n}", { Arg("n", "sets") }) == "use {} for sets");
+    CHECK(format("'{it''s}' {n}", { Arg("n", 1) }) == "{it's} 1");
+    CHECK(format("don't {n}", { Arg("n", 1) }) == "don't 1");
+    CHECK(format("{n, plural, one {'#' #} other {# '{x}'}}", { Arg("n", 1) }) == "# 1");
+    CHECK(format("{n, plural, one {'#' #} other {# '{x}'}}", { Arg("n", 2) }) == "2 {x}");
+    CHECK(format("{n, select, a {'}'} other {x}}", { Arg("n", "a") }) == "}");
+    CHECK(format("'{unterminated", {}) == "{unterminated");
+    CHECK(throws("use {} for sets"));
+    CHECK(throws("{n"));
+}
+
+// 解析不了的译文按普通文字处理，不影响其他条目
+static void testLiteralFallback() {
+    Language language(R"({"a":"hello","b":"use {} for sets","c":"{n} items","d":"a { b","e":"x } y"})");
+    CHECK(language.find(intern("a")) == std::optional<std::string_view>("hello"));
+    CHECK(language.find(intern("b")) == std::optional<std::string_view>("use {} for sets"));
+    CHECK(language.format(intern("b")) == nullptr);
+    CHECK(language.format(intern("d")) == nullptr);
+    CHECK(language.find(intern("e")) == std::optional<std::string_view>("x } y"));
+    const MessageFormat* items = language.format(intern("c"));
+    CHECK(items != nullptr);
+    if (items) {
+        std::string output;
+        items->format(output, { Arg("n", 2) });
+        CHECK(output == "2 items");
+    }
+
+    const std::string catalog = Language::compile(R"({"b":"use {} for sets","c":"{n} items"})");
+    auto owner = std::make_shared<const std::string>(catalog);
+    Language loaded = Language::fromCatalog(*owner, owner);
+    CHECK(loaded.find(intern("b")) == std::optional<std::string_view>("use {} for sets"));
+    CHECK(loaded.format(intern("b")) == nullptr);
+    CHECK(loaded.format(intern("c")) != nullptr);
+}
+
+// 模板在第一次查找时编译，合并回退链时共享已编译的模板
+static void testLazyFormats() {
+    auto base = std::make_shared<const Language>(Language(R"({"f":"{n} files","g":"{n} dirs","h":"plain"})"));
+    const MessageFormat* files = base->format(intern("f"));
+    CHECK(files != nullptr);
+    CHECK(base->format(intern("f")) == files);
+    CHECK(base->format(intern("h")) == nullptr);
+    CHECK(base->format(intern("h")) == nullptr);
+    CHECK(base->format(intern("missing")) == nullptr);
+
+    auto top = std::make_shared<const Language>(Language(R"({"g":"{n} folders"})"));
+    Language merged = Language::flatten({ top, base });
+    CHECK(merged.format(intern("f")) == files);
+    const MessageFormat* folders = merged.format(intern("g"));
+    CHECK(folders != nullptr);
+    if (folders) {
+        std::string output;
+        folders->format(output, { Arg("n", 3) });
+        CHECK(output == "3 folders");
+    }
+}
+
+int main() {
+    testQuoting();
+    testLiteralFallback();
+    testLazyFormats();
+    if (failures) std::fprintf(stderr, "%d check(s) failed\n", failures);
+    return failures ? 1 : 0;
+}
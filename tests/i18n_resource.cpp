@@ -0,0 +1,58 @@
+// 嵌入程序的语言资源的测试（仅 Linux）
+// tools/embed_resources.sh zh_json.o tests/data/zh.json
+// g++ -std=c++17 -I. -Iinclude tests/i18n_resource.cpp zh_json.o chh.cpp hti.*.cpp include/json/*.cpp -pthread
+#include "hti.hpp"
+
+using namespace hti;
+using namespace hti::i18n;
+
+CHH_RESOURCE("lang/zh", zh_json)
+
+static int failures = 0;
+
+#define CHECK(expr) do { \
+    if (!(expr)) { \
+        std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #expr); \
+        failures++; \
+    } \
+} while (0)
+
+// 资源就是文件的内容，直接引用程序映像。
+static void testResource() {
+    const auto file = chh::readFile("tests/data/zh.json");
+    const std::string_view data = chh::viewResource("lang/zh");
+    CHECK(data == std::string_view(file.data(), file.size()));
+    bool thrown = false;
+    try {
+        chh::viewResource("lang/missing");
+    }
+    catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+static void testLoad() {
+    auto* app = new Application();
+    app->loadLanguageFromResource("zh", "lang/zh");
+    auto snapshot = app->languages().snapshot();
+    auto it = snapshot->languages.find("zh");
+    CHECK(it != snapshot->languages.end());
+    if (it == snapshot->languages.end()) return;
+    const Language& language = *it->second;
+    CHECK(language.find(intern("hello")) == std::optional<std::string_view>("你好"));
+    const MessageFormat* items = language.format(intern("items"));
+    CHECK(items != nullptr);
+    if (items) {
+        std::string output;
+        items->format(output, { Arg("n", 3) });
+        CHECK(output == "3 个文件");
+    }
+}
+
+int main() {
+    testResource();
+    testLoad();
+    if (failures) std::fprintf(stderr, "%d check(s) failed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,157 @@
+// Json::FlatMap tests: the sorted vector behind objects and arrays when
+// JSON_USE_FLAT_OBJECT_VALUES is set must behave like the std::map it
+// replaces, on both sides of the linear search limit.
+// g++ -std=c++17 -DJSON_USE_FLAT_OBJECT_VALUES=1 -Iinclude tests/json_flat_map.cpp include/json/json_*.cpp
+#include <json/json.h>
+
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+
+#if !JSON_USE_FLAT_OBJECT_VALUES
+#error "build with -DJSON_USE_FLAT_OBJECT_VALUES=1"
+#endif
+
+static int failures = 0;
+
+#define CHECK(expr)                                                            \
+  do {                                                                         \
+    if (!(expr)) {                                                             \
+      std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__,    \
+                   #expr);                                                     \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+using Counted = std::shared_ptr<int>;
+using Map =
+    Json::FlatMap<int, Counted, std::allocator<std::pair<int, Counted>>>;
+
+static bool sorted(const Map& map) {
+  for (auto it = map.begin(); it != map.end() && it + 1 != map.end(); ++it)
+    if (!(it->first < (it + 1)->first))
+      return false;
+  return true;
+}
+
+// Erasing rotates the member to the back and destroys it there; the rest
+// keep their order and values.
+static void testErase() {
+  for (int size : {3, 8, 9, 20}) {
+    Map map;
+    std::map<int, Counted> expected;
+    for (int i = 0; i < size; i++) {
+      auto value = std::make_shared<int>(i * 10);
+      map.emplace(i, value);
+      expected.emplace(i, value);
+    }
+    for (int key : {size / 2, 0, size - 1}) {
+      std::weak_ptr<int> const watched = expected[key];
+      expected.erase(key);
+      CHECK(map.erase(key) == 1);
+      CHECK(watched.expired());
+      CHECK(map.erase(key) == 0);
+    }
+    CHECK(map.size() == expected.size());
+    CHECK(sorted(map));
+    auto it = map.begin();
+    for (const auto& member : expected) {
+      CHECK(it != map.end() && it->first == member.first &&
+            it->second == member.second);
+      ++it;
+    }
+    // erase(iterator) returns the member that followed.
+    if (map.size() >= 2) {
+      int const next = (map.begin() + 1)->first;
+      CHECK(map.erase(map.begin())->first == next);
+    }
+  }
+}
+
+// Out-of-order inserts past the linear search limit stay sorted and
+// findable, and insert() ignores wrong hints.
+static void testOrdering() {
+  Map map;
+  int const keys[] = {50, 10, 40, 20, 30, 90, 0, 70, 60, 80, 15, 55, 5};
+  for (int key : keys) {
+    map.insert(map.begin(), {key, std::make_shared<int>(key)});
+    CHECK(sorted(map));
+  }
+  CHECK(map.size() == sizeof(keys) / sizeof(keys[0]));
+  CHECK(map.size() > Map::linearSearchLimit);
+  for (int key : keys) {
+    auto it = map.find(key);
+    CHECK(it != map.end() && *it->second == key);
+  }
+  CHECK(map.find(25) == map.end());
+  CHECK(map.lower_bound(25)->first == 30);
+  CHECK(map.lower_bound(100) == map.end());
+  // Existing keys are not replaced.
+  auto it = map.insert(map.end(), {40, std::make_shared<int>(-1)});
+  CHECK(*it->second == 40);
+  CHECK(!map.emplace(40, std::make_shared<int>(-1)).second);
+  CHECK(map[40] && *map[40] == 40);
+  CHECK(!map[41]);
+  CHECK(sorted(map));
+}
+
+// Json::Value on top of FlatMap: member order, iterators and removal.
+static void testValueIterators() {
+  Json::Value object;
+  char const* const names[] = {"kilo", "alpha", "juliet", "bravo", "india",
+                               "charlie", "hotel", "delta", "golf", "echo",
+                               "foxtrot"};
+  int n = 0;
+  for (char const* name : names)
+    object[name] = n++;
+  CHECK(object.size() == 11);
+
+  Json::String previous;
+  int seen = 0;
+  for (auto it = object.begin(); it != object.end(); ++it) {
+    Json::String const name = it.name();
+    CHECK(previous < name);
+    CHECK(it.key().asString() == name);
+    CHECK(*it == object[name]);
+    previous = name;
+    seen++;
+  }
+  CHECK(seen == 11);
+
+  auto last = object.end();
+  --last;
+  CHECK(last.name() == "kilo");
+  CHECK(object.end() - object.begin() == 11);
+
+  Json::Value removed;
+  CHECK(object.removeMember("delta", &removed));
+  CHECK(removed.asInt() == 7);
+  CHECK(!object.isMember("delta"));
+  CHECK(object.size() == 10);
+  CHECK(object.getMemberNames().front() == "alpha");
+  CHECK(object.getMemberNames().back() == "kilo");
+
+  Json::Value array;
+  for (int i = 0; i < 12; i++)
+    array.append(i);
+  CHECK(array.removeIndex(3, &removed));
+  CHECK(removed.asInt() == 3);
+  CHECK(array.size() == 11);
+  for (Json::ArrayIndex i = 0; i < array.size(); i++)
+    CHECK(array[i].asInt() == int(i < 3 ? i : i + 1));
+
+  Json::Value const copy = object;
+  CHECK(copy == object);
+  object["zulu"] = 1;
+  CHECK(copy < object || object < copy);
+}
+
+int main() {
+  testErase();
+  testOrdering();
+  testValueIterators();
+  if (failures)
+    std::fprintf(stderr, "%d check(s) failed\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,138 @@
+// CharReader::parseInSitu tests: strings are decoded inside the document and
+// borrowed by the Values, so they must point into the buffer, survive
+// copies, and write back out the same as a normal parse.
+// g++ -std=c++17 -Iinclude tests/json_reader_insitu.cpp include/json/json_*.cpp
+#include <json/json.h>
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(expr)                                                            \
+  do {                                                                         \
+    if (!(expr)) {                                                             \
+      std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__,    \
+                   #expr);                                                     \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+// The document is parsed in place, so it is kept in a buffer that the test
+// can inspect and that outlives the Value.
+struct Document {
+  std::vector<char> buffer;
+  Json::Value root;
+  bool ok;
+
+  explicit Document(const char* text) : buffer(text, text + strlen(text)) {
+    Json::CharReaderBuilder builder;
+    std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    Json::String errors;
+    ok = reader->parseInSitu(buffer.data(), buffer.data() + buffer.size(),
+                             &root, &errors);
+  }
+
+  bool owns(const Json::Value& value) const {
+    char const* begin;
+    char const* end;
+    return value.getString(&begin, &end) && begin >= buffer.data() &&
+           end <= buffer.data() + buffer.size();
+  }
+};
+
+static Json::Value parseCopying(const char* text) {
+  Json::CharReaderBuilder builder;
+  std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+  Json::Value root;
+  Json::String errors;
+  reader->parse(text, text + strlen(text), &root, &errors);
+  return root;
+}
+
+static Json::String content(const Json::Value& value) {
+  char const* begin;
+  char const* end;
+  if (!value.getString(&begin, &end))
+    return "<not a string>";
+  return Json::String(begin, end);
+}
+
+// Escapes decode to fewer bytes than they take in the document.
+static void testShrinkingEscapes() {
+  Document doc(R"(["a\nb", "\u00e9t\u00e9", "\ud83d\ude00!", "\\\"\/", "plain"])");
+  CHECK(doc.ok);
+  if (!doc.ok)
+    return;
+  CHECK(content(doc.root[0]) == "a\nb");
+  CHECK(content(doc.root[1]) == "\xC3\xA9t\xC3\xA9");
+  CHECK(content(doc.root[2]) == "\xF0\x9F\x98\x80!");
+  CHECK(content(doc.root[3]) == "\\\"/");
+  CHECK(content(doc.root[4]) == "plain");
+  for (Json::ArrayIndex i = 0; i < doc.root.size(); i++) {
+    CHECK(doc.owns(doc.root[i]));
+    // Terminated in place, so asCString sees exactly the decoded text.
+    CHECK(strlen(doc.root[i].asCString()) == content(doc.root[i]).size());
+  }
+}
+
+static void testEmptyStrings() {
+  Document doc(R"({"empty":"","list":["",""],"":"empty key"})");
+  CHECK(doc.ok);
+  if (!doc.ok)
+    return;
+  CHECK(doc.root["empty"].isString());
+  CHECK(content(doc.root["empty"]).empty());
+  CHECK(doc.root["empty"].asCString()[0] == '\0');
+  CHECK(doc.root["empty"] == Json::Value(""));
+  CHECK(content(doc.root["list"][1]).empty());
+  CHECK(doc.root[""].asString() == "empty key");
+}
+
+// Copies of a borrowed string refer to the same characters.
+static void testCopyBorrowed() {
+  Document doc(R"({"name":"a string that would not be inline","short":"x"})");
+  CHECK(doc.ok);
+  if (!doc.ok)
+    return;
+  Json::Value copy = doc.root;
+  CHECK(copy == doc.root);
+  CHECK(doc.owns(copy["name"]));
+  CHECK(copy["name"].asCString() == doc.root["name"].asCString());
+  CHECK(doc.owns(copy["short"]));
+
+  Json::Value member = doc.root["name"];
+  CHECK(member.asCString() == doc.root["name"].asCString());
+  // Assigning a new string replaces the borrowed one without touching it.
+  member = "replaced";
+  CHECK(!doc.owns(member));
+  CHECK(content(doc.root["name"]) == "a string that would not be inline");
+}
+
+// Writing an in-situ document gives the same text as a normal parse.
+static void testWriteBack() {
+  const char* const text =
+      R"({"a":"tab\there","b":["中文",1,2.5,true,null],"c":{"d":""},"e":"\ud83d\ude00 \u4e2d"})";
+  Document doc(text);
+  CHECK(doc.ok);
+  Json::Value const expected = parseCopying(text);
+  CHECK(doc.root == expected);
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "";
+  CHECK(Json::writeString(builder, doc.root) ==
+        Json::writeString(builder, expected));
+  CHECK(Json::BufferWriter().write(doc.root) ==
+        Json::BufferWriter().write(expected));
+}
+
+int main() {
+  testShrinkingEscapes();
+  testEmptyStrings();
+  testCopyBorrowed();
+  testWriteBack();
+  if (failures)
+    std::fprintf(stderr, "%d check(s) failed\n", failures);
+  return failures ? 1 : 0;
+}
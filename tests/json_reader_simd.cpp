@@ -0,0 +1,163 @@
+// Checks that OurReader's SSE2 scanners agree with the scalar ones, and that
+// parsing is unaffected when strings, escapes, whitespace runs and digit runs
+// straddle 16-byte boundaries. The reader source is included directly so its
+// file-local scanners can be called.
+//
+//   g++ -std=c++17 -Iinclude tests/json_reader_simd.cpp include/json/json_value.cpp include/json/json_writer.cpp
+//
+// Build once more with -DJSONCPP_NO_SIMD; the end-to-end checks must pass on
+// the scalar path as well.
+#include "../include/json/json_reader.cpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+using namespace Json;
+
+static int failures = 0;
+
+#define CHECK(expr)                                                            \
+  do {                                                                         \
+    if (!(expr)) {                                                             \
+      std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__,    \
+                   #expr);                                                     \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+// Deterministic so that failures reproduce.
+static unsigned nextRandom() {
+  static unsigned state = 12345;
+  state = state * 1103515245u + 12345u;
+  return state >> 16;
+}
+
+// Every scanner on every start offset of buffers where a stop character is
+// placed at each position in turn, plus random buffers.
+static void testScannersAgree() {
+  static const char fill[] = {' ', 'a', '5', '"', '\\', '\'', '\n', '\t',
+                              '\r', '/', '\x80', '\xff', '0', '9', ':'};
+  for (size_t length = 0; length <= 80; ++length) {
+    for (char base : {' ', 'x', '7', '\n'}) {
+      for (size_t stop = 0; stop <= length; ++stop) {
+        for (char c : fill) {
+          String buffer(length, base);
+          if (stop < length)
+            buffer[stop] = c;
+          const char* const begin = buffer.data();
+          const char* const end = begin + buffer.size();
+          for (const char* p = begin; p <= end; ++p) {
+            CHECK(skipWhitespace(p, end) == skipWhitespaceScalar(p, end));
+            CHECK(skipDigits(p, end) == skipDigitsScalar(p, end));
+            CHECK(findQuoteOrEscape(p, end, '"') ==
+                  findQuoteOrEscapeScalar(p, end, '"'));
+            CHECK(findQuoteOrEscape(p, end, '\'') ==
+                  findQuoteOrEscapeScalar(p, end, '\''));
+          }
+        }
+      }
+    }
+  }
+  for (int round = 0; round < 2000; ++round) {
+    String buffer(nextRandom() % 100, ' ');
+    for (char& c : buffer)
+      c = fill[nextRandom() % sizeof(fill)];
+    const char* const begin = buffer.data();
+    const char* const end = begin + buffer.size();
+    for (const char* p = begin; p <= end; ++p) {
+      CHECK(skipWhitespace(p, end) == skipWhitespaceScalar(p, end));
+      CHECK(skipDigits(p, end) == skipDigitsScalar(p, end));
+      CHECK(findQuoteOrEscape(p, end, '"') ==
+            findQuoteOrEscapeScalar(p, end, '"'));
+    }
+  }
+}
+
+static bool parse(const String& doc, Value& root, String& errors) {
+  CharReaderBuilder builder;
+  builder["allowSingleQuotes"] = true;
+  std::unique_ptr<CharReader> const reader(builder.newCharReader());
+  return reader->parse(doc.data(), doc.data() + doc.size(), &root, &errors);
+}
+
+// Escapes at every offset around 16-byte boundaries, with the string itself
+// starting at every alignment.
+static void testEscapesOnBoundaries() {
+  struct Escape {
+    const char* source;
+    const char* decoded;
+  };
+  static const Escape escapes[] = {
+      {"\\\"", "\""},
+      {"\\\\", "\\"},
+      {"\\n", "\n"},
+      {"\\/", "/"},
+      {"\\u00e9", "\xC3\xA9"},
+      {"\\ud83d\\ude00", "\xF0\x9F\x98\x80"},
+  };
+  for (size_t indent = 0; indent < 16; ++indent) {
+    for (size_t offset = 0; offset <= 40; ++offset) {
+      for (const Escape& escape : escapes) {
+        String const before(offset, 'a');
+        String const after(40 - offset, 'b');
+        String const doc = String(indent, ' ') + "[\"" + before +
+                           escape.source + after + "\", '" + before +
+                           escape.source + after + "']";
+        String const expected = before + escape.decoded + after;
+        Value root;
+        String errors;
+        bool const ok =
+            parse(doc, root, errors) && root.isArray() && root.size() == 2;
+        CHECK(ok);
+        if (ok) {
+          CHECK(root[0].asString() == expected);
+          CHECK(root[1].asString() == expected);
+        }
+      }
+    }
+  }
+}
+
+// Whitespace and digit runs of every length, and errors whose position must
+// not move.
+static void testRunsAndErrors() {
+  for (size_t length = 1; length <= 70; ++length) {
+    String space;
+    for (size_t i = 0; i < length; ++i)
+      space += " \t\r\n"[i % 4];
+    String digits;
+    for (size_t i = 0; i < length; ++i)
+      digits += char('1' + i % 9);
+    String const doc =
+        "{" + space + "\"n\"" + space + ":" + space + digits + space + "}";
+    Value root;
+    String errors;
+    CHECK(parse(doc, root, errors) && root.isObject());
+    CHECK(root.get("n", Value()).asDouble() ==
+          std::strtod(digits.c_str(), nullptr));
+
+    String const fraction = "[0." + digits + "e-" + std::to_string(length) + "]";
+    CHECK(parse(fraction, root, errors) && root.isArray());
+    CHECK(root.get(ArrayIndex(0), Value()).asDouble() ==
+          std::strtod(fraction.c_str() + 1, nullptr));
+
+    // An unterminated string is reported at the string's start, and an
+    // invalid escape at the escape, wherever they fall.
+    String const unterminated = String(length, ' ') + "\"" + digits;
+    CHECK(!parse(unterminated, root, errors));
+    CHECK(errors.find("Column " + std::to_string(length + 1)) != String::npos);
+
+    String const invalid = "[\"" + digits + "\\q\"]";
+    CHECK(!parse(invalid, root, errors));
+    CHECK(errors.find("Bad escape sequence") != String::npos);
+  }
+}
+
+int main() {
+  testScannersAgree();
+  testEscapesOnBoundaries();
+  testRunsAndErrors();
+  if (failures)
+    std::fprintf(stderr, "%d check(s) failed\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,146 @@
+// Json::StreamReader tests: NDJSON split into arbitrary chunks must yield
+// the same documents as the whole input, with the buffer reused.
+// g++ -std=c++17 -Iinclude tests/json_stream_reader.cpp include/json/json_*.cpp
+#include <json/json.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(expr)                                                            \
+  do {                                                                         \
+    if (!(expr)) {                                                             \
+      std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__,    \
+                   #expr);                                                     \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static std::vector<Json::Value> drain(Json::StreamReader& stream,
+                                      int* invalid = nullptr) {
+  std::vector<Json::Value> documents;
+  Json::Value root;
+  Json::String errs;
+  while (auto result = stream.next(&root, &errs)) {
+    if (result == Json::StreamReader::document)
+      documents.push_back(root);
+    else if (invalid)
+      ++*invalid;
+  }
+  return documents;
+}
+
+static const char input[] = "{\"id\":1,\"name\":\"first\"}\n"
+                            "\n"
+                            "[1,2,3]\r\n"
+                            "   \t\r\n"
+                            "{\"id\":2,\"text\":\"\\u4e2d\\n\"}\n"
+                            "\"last\"";
+
+static void checkDocuments(const std::vector<Json::Value>& documents) {
+  CHECK(documents.size() == 4);
+  if (documents.size() != 4)
+    return;
+  CHECK(documents[0]["name"].asString() == "first");
+  CHECK(documents[1].size() == 3 && documents[1][2].asInt() == 3);
+  CHECK(documents[2]["text"].asString() == "\xE4\xB8\xAD\n");
+  CHECK(documents[3].asString() == "last");
+}
+
+// Every chunk size, so each line is split at every possible byte,
+// including between \r and \n.
+static void testChunkSplits() {
+  size_t const length = sizeof(input) - 1;
+  for (size_t chunk = 1; chunk <= length; chunk++) {
+    Json::StreamReader stream;
+    std::vector<Json::Value> documents;
+    for (size_t pos = 0; pos < length; pos += chunk) {
+      stream.feed(input + pos, std::min(chunk, length - pos));
+      for (auto& document : drain(stream))
+        documents.push_back(document);
+    }
+    // The last line has no newline, so it only comes out after finish().
+    CHECK(documents.size() == 3);
+    stream.finish();
+    for (auto& document : drain(stream))
+      documents.push_back(document);
+    checkDocuments(documents);
+  }
+}
+
+static void testCrlfAndInvalidLines() {
+  Json::StreamReader stream;
+  char const text[] = "{\"a\":1}\r\n{broken\r\n2\r\n";
+  stream.feed(text, sizeof(text) - 1);
+  int invalid = 0;
+  auto documents = drain(stream, &invalid);
+  CHECK(invalid == 1);
+  CHECK(documents.size() == 2);
+  if (documents.size() == 2) {
+    CHECK(documents[0]["a"].asInt() == 1);
+    CHECK(documents[1].asInt() == 2);
+  }
+}
+
+static void testFinish() {
+  Json::StreamReader empty;
+  empty.finish();
+  CHECK(drain(empty).empty());
+
+  Json::StreamReader stream;
+  stream.feed("{\"x\":", 5);
+  CHECK(drain(stream).empty());
+  stream.feed("true}", 5);
+  CHECK(drain(stream).empty());
+  stream.finish();
+  auto documents = drain(stream);
+  CHECK(documents.size() == 1 && documents[0]["x"].asBool());
+  CHECK(drain(stream).empty());
+}
+
+// prepare()/commit() writes straight into the buffer; returned lines are
+// dropped before it grows, so a steady stream stays in one buffer.
+static void testPrepareCommit() {
+  Json::StreamReader stream;
+  char const line[] = "{\"k\":\"0123456789\"}\n";
+  size_t const size = sizeof(line) - 1;
+  char* first = nullptr;
+  for (int i = 0; i < 1000; i++) {
+    char* room = stream.prepare(size);
+    if (i == 0)
+      first = room;
+    memcpy(room, line, size);
+    // Commit a line in two parts to split it across commits.
+    stream.commit(size / 2);
+    stream.commit(size - size / 2);
+    auto documents = drain(stream);
+    CHECK(documents.size() == 1);
+    CHECK(room == first);
+  }
+
+  // A partial line is kept at the front when the buffer is compacted.
+  Json::StreamReader partial;
+  char* room = partial.prepare(64);
+  char const head[] = "[1]\n[2]\n[3";
+  memcpy(room, head, sizeof(head) - 1);
+  partial.commit(sizeof(head) - 1);
+  CHECK(drain(partial).size() == 2);
+  room = partial.prepare(4096);
+  memcpy(room, "]\n", 2);
+  partial.commit(2);
+  auto documents = drain(partial);
+  CHECK(documents.size() == 1 && documents[0][0].asInt() == 3);
+}
+
+int main() {
+  testChunkSplits();
+  testCrlfAndInvalidLines();
+  testFinish();
+  testPrepareCommit();
+  if (failures)
+    std::fprintf(stderr, "%d check(s) failed\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,126 @@
+// Json::ValueArena tests: documents built inside a scope live in the arena,
+// and copies made outside any scope escape it onto the heap.
+// g++ -std=c++17 -DJSON_USE_VALUE_ARENA=1 -Iinclude tests/json_value_arena.cpp include/json/json_*.cpp
+#include <json/json.h>
+
+#include <cstdio>
+#include <memory>
+
+#if !JSON_USE_VALUE_ARENA
+#error "build with -DJSON_USE_VALUE_ARENA=1"
+#endif
+
+static int failures = 0;
+
+#define CHECK(expr)                                                            \
+  do {                                                                         \
+    if (!(expr)) {                                                             \
+      std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__,    \
+                   #expr);                                                     \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static const char document[] =
+    R"({"name":"a name that is too long to be inline","short":"x",)"
+    R"("list":[1,"two",{"nested key that is long":"nested value that is long"}]})";
+
+static bool parse(Json::Value& root) {
+  Json::CharReaderBuilder builder;
+  std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+  Json::String errors;
+  return reader->parse(document, document + sizeof(document) - 1, &root,
+                       &errors);
+}
+
+static void checkDocument(const Json::Value& root) {
+  CHECK(root["name"].asString() == "a name that is too long to be inline");
+  CHECK(root["short"].asString() == "x");
+  CHECK(root["list"].size() == 3);
+  CHECK(root["list"][1].asString() == "two");
+  CHECK(root["list"][2]["nested key that is long"].asString() ==
+        "nested value that is long");
+}
+
+// Parsing inside a scope draws from the arena.
+static void testParseInArena() {
+  Json::ValueArena arena(1024);
+  Json::Value root;
+  {
+    Json::ValueArena::Scope scope(arena);
+    CHECK(Json::ValueArena::current() == &arena);
+    CHECK(parse(root));
+  }
+  CHECK(Json::ValueArena::current() == nullptr);
+  CHECK(arena.reserved() > 0);
+  checkDocument(root);
+}
+
+// A copy made outside any scope owns heap memory and outlives the arena.
+// Run under AddressSanitizer to catch anything still pointing into it.
+static void testEscapeByCopy() {
+  Json::Value escaped;
+  {
+    auto arena = std::make_unique<Json::ValueArena>(1024);
+    Json::Value root;
+    {
+      Json::ValueArena::Scope scope(*arena);
+      CHECK(parse(root));
+    }
+    escaped = root;
+    Json::Value member = root["list"][2];
+    escaped["copied member"] = member;
+    root = Json::Value();
+    member = Json::Value();
+    CHECK(arena->reserved() > 0);
+    arena.reset();
+  }
+  checkDocument(escaped);
+  CHECK(escaped["copied member"]["nested key that is long"].asString() ==
+        "nested value that is long");
+  // The escaped document can still grow and be copied.
+  escaped["list"].append("appended after the arena is gone");
+  Json::Value again = escaped;
+  CHECK(again["list"][3].asString() == "appended after the arena is gone");
+  CHECK(again == escaped);
+}
+
+// Scopes nest, and the previous arena comes back when the inner one ends.
+static void testNestedScopes() {
+  Json::ValueArena outer;
+  Json::ValueArena inner;
+  Json::ValueArena::Scope outerScope(outer);
+  {
+    Json::ValueArena::Scope innerScope(inner);
+    CHECK(Json::ValueArena::current() == &inner);
+  }
+  CHECK(Json::ValueArena::current() == &outer);
+}
+
+// Adding members to a heap container while an arena is current would leave
+// it pointing into the arena, so it is rejected.
+static void testMismatchedArena() {
+  Json::Value heap(Json::objectValue);
+  Json::ValueArena arena;
+  Json::ValueArena::Scope scope(arena);
+  bool thrown = false;
+  try {
+    heap["member"] = "value";
+  } catch (const Json::LogicError&) {
+    thrown = true;
+  }
+  CHECK(thrown);
+  Json::Value local(Json::objectValue);
+  local["member"] = "value";
+  CHECK(local["member"].asString() == "value");
+}
+
+int main() {
+  testParseInArena();
+  testEscapeByCopy();
+  testNestedScopes();
+  testMismatchedArena();
+  if (failures)
+    std::fprintf(stderr, "%d check(s) failed\n", failures);
+  return failures ? 1 : 0;
+}
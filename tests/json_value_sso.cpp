@@ -0,0 +1,165 @@
+// Json::Value short string tests: strings of up to 13 bytes are stored
+// inside the Value, longer ones on the heap. Both must behave the same
+// through the public API.
+// g++ -std=c++17 -Iinclude tests/json_value_sso.cpp include/json/json_*.cpp
+#include <json/json.h>
+
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+static int failures = 0;
+
+#define CHECK(expr)                                                            \
+  do {                                                                         \
+    if (!(expr)) {                                                             \
+      std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__,    \
+                   #expr);                                                     \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+// Whether the characters of a string value live inside the Value itself.
+static bool isInline(const Json::Value& value) {
+  char const* begin;
+  char const* end;
+  if (!value.getString(&begin, &end))
+    return false;
+  char const* self = reinterpret_cast<char const*>(&value);
+  return begin >= self && begin < self + sizeof(Json::Value);
+}
+
+static bool hasContent(const Json::Value& value, const Json::String& expected) {
+  char const* begin;
+  char const* end;
+  if (!value.getString(&begin, &end))
+    return false;
+  return Json::String(begin, end) == expected && value.asString() == expected;
+}
+
+// 13 bytes fit with their terminator, 14 do not.
+static void testBoundary() {
+  for (size_t length = 0; length <= 20; length++) {
+    Json::String const text(length, 'a' + char(length));
+    Json::Value value(text);
+    CHECK(isInline(value) == (length <= 13));
+    CHECK(hasContent(value, text));
+    CHECK(std::strlen(value.asCString()) == length);
+    CHECK(value.asCString()[length] == '\0');
+  }
+  CHECK(isInline(Json::Value("1234567890abc")));
+  CHECK(!isInline(Json::Value("1234567890abcd")));
+}
+
+static void testEmbeddedZeros() {
+  Json::String const shortText("a\0b\0c", 5);
+  Json::String const longText("0123456789\0abcdef", 17);
+  Json::Value a(shortText.data(), shortText.data() + shortText.size());
+  Json::Value b(longText.data(), longText.data() + longText.size());
+  CHECK(isInline(a));
+  CHECK(!isInline(b));
+  CHECK(hasContent(a, shortText));
+  CHECK(hasContent(b, longText));
+  // asCString stops at the first zero, as it always has.
+  CHECK(std::strcmp(a.asCString(), "a") == 0);
+  CHECK(a != Json::Value("a"));
+  CHECK(Json::Value("a") < a);
+}
+
+static void testCopyMoveSwap() {
+  Json::Value const shortValue("short");
+  Json::Value const longValue("a string that is too long to be inline");
+
+  Json::Value copy(shortValue);
+  CHECK(isInline(copy));
+  CHECK(copy == shortValue);
+  // The copy has its own characters, not a pointer into the original.
+  CHECK(copy.asCString() != shortValue.asCString());
+
+  Json::Value moved(std::move(copy));
+  CHECK(isInline(moved));
+  CHECK(hasContent(moved, "short"));
+
+  Json::Value assigned;
+  assigned = longValue;
+  CHECK(hasContent(assigned, longValue.asString()));
+  assigned = shortValue;
+  CHECK(isInline(assigned));
+  CHECK(hasContent(assigned, "short"));
+
+  Json::Value a("left");
+  Json::Value b("the right hand side is long");
+  a.swap(b);
+  CHECK(hasContent(a, "the right hand side is long"));
+  CHECK(hasContent(b, "left"));
+  CHECK(isInline(b));
+  swap(a, b);
+  CHECK(isInline(a));
+  CHECK(hasContent(a, "left"));
+
+  // Replacing a string with another type and back must not leave stale
+  // characters behind.
+  Json::Value changed("inline");
+  changed = 42;
+  CHECK(changed.isInt());
+  changed = "again";
+  CHECK(hasContent(changed, "again"));
+}
+
+static void testCompare() {
+  Json::Value const a("abc");
+  Json::Value const b("abd");
+  Json::Value const longA("abcdefghijklmnopqrstuvwxyz");
+  Json::Value const longB("abcdefghijklmnopqrstuvwxyZ");
+  CHECK(a < b);
+  CHECK(a.compare(b) < 0);
+  CHECK(b.compare(a) > 0);
+  CHECK(a.compare(Json::Value("abc")) == 0);
+  // Inline against heap: ordered by content, not by storage.
+  CHECK(a < longA);
+  CHECK(longB < longA);
+  CHECK(Json::Value("1234567890abc") < Json::Value("1234567890abcd"));
+  CHECK(Json::Value("1234567890abc") == Json::Value(Json::String("1234567890abc")));
+  CHECK(Json::Value("") < Json::Value("a"));
+  CHECK(Json::Value("") == Json::Value(""));
+}
+
+static void testObjectKeys() {
+  Json::Value object;
+  object["k"] = "v";
+  object["a longer member key"] = "long key";
+  object[Json::String("z\0z", 3)] = "zero";
+  object["1234567890abc"] = Json::Value("1234567890abc");
+  CHECK(object.size() == 4);
+  CHECK(object["k"] == Json::Value("v"));
+  CHECK(object.isMember("a longer member key"));
+  CHECK(object[Json::String("z\0z", 3)] == Json::Value("zero"));
+  CHECK(!object.isMember("z"));
+
+  size_t seen = 0;
+  for (auto it = object.begin(); it != object.end(); ++it) {
+    Json::Value const key = it.key();
+    CHECK(key.isString());
+    CHECK(object[key.asString()] == *it);
+    seen++;
+  }
+  CHECK(seen == 4);
+
+  // Values stored in an object survive the map growing around them.
+  Json::Value grown;
+  for (int i = 0; i < 64; i++)
+    grown[std::to_string(i)] = std::to_string(i * i);
+  for (int i = 0; i < 64; i++)
+    CHECK(grown[std::to_string(i)].asString() == std::to_string(i * i));
+}
+
+int main() {
+  testBoundary();
+  testEmbeddedZeros();
+  testCopyMoveSwap();
+  testCompare();
+  testObjectKeys();
+  if (failures)
+    std::fprintf(stderr, "%d check(s) failed\n", failures);
+  return failures ? 1 : 0;
+}
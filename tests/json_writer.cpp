@@ -0,0 +1,97 @@
+// Json::BufferWriter tests: apart from reals, which BufferWriter writes with
+// the fewest digits that read back the same, output must match FastWriter
+// byte for byte.
+// g++ -std=c++17 -Iinclude tests/json_writer.cpp include/json/json_*.cpp
+#include <json/json.h>
+
+#include <cstdio>
+#include <limits>
+
+static int failures = 0;
+
+#define CHECK(expr)                                                            \
+  do {                                                                         \
+    if (!(expr)) {                                                             \
+      std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__,    \
+                   #expr);                                                     \
+      failures++;                                                              \
+    }                                                                          \
+  } while (0)
+
+static Json::String fastWrite(const Json::Value& value) {
+  Json::FastWriter writer;
+  writer.omitEndingLineFeed();
+  return writer.write(value);
+}
+
+static void checkSame(const Json::Value& value) {
+  Json::BufferWriter writer;
+  Json::String const expected = fastWrite(value);
+  Json::String const actual = writer.write(value);
+  if (actual != expected)
+    std::fprintf(stderr, "expected %s\n  actual %s\n", expected.c_str(),
+                 actual.c_str());
+  CHECK(actual == expected);
+}
+
+// Arrays with holes, e.g. after `a[3] = 1`.
+static void testSparseArrays() {
+  Json::Value a;
+  a[3] = 1;
+  checkSame(a);
+  CHECK(Json::BufferWriter().write(a) == "[null,null,null,1]");
+
+  Json::Value b;
+  b[0] = "x";
+  b[2] = true;
+  b[5][1] = 2.5;
+  checkSame(b);
+  CHECK(Json::BufferWriter().write(b) ==
+        "[\"x\",null,true,null,null,[null,2.5]]");
+
+  Json::Value c(Json::arrayValue);
+  c.resize(3);
+  checkSame(c);
+
+  Json::Value d;
+  d["k"][1] = Json::Value(Json::objectValue);
+  checkSame(d);
+}
+
+static void testScalarsAndNesting() {
+  Json::Value root;
+  root["null"] = Json::Value();
+  root["int"] = Json::Int64(-9223372036854775807LL - 1);
+  root["uint"] = Json::UInt64(18446744073709551615ULL);
+  root["real"] = 2.5;
+  root["nan"] = std::numeric_limits<double>::quiet_NaN();
+  root["string"] = "quote \" slash \\ tab \t \xE4\xB8\xAD";
+  root["empty"] = Json::Value(Json::arrayValue);
+  root["object"] = Json::Value(Json::objectValue);
+  root["list"].append(1);
+  root["list"].append("two");
+  root["list"].append(Json::Value());
+  checkSame(root);
+}
+
+// Shortest reals still read back as the same double.
+static void testReals() {
+  const double values[] = {0.1, 1.0 / 3.0, 1e300, -2.2250738585072014e-308,
+                           123456789012345678.0};
+  for (double value : values) {
+    Json::Value parsed;
+    Json::Reader reader;
+    CHECK(reader.parse(Json::BufferWriter().write(Json::Value(value)), parsed));
+    CHECK(parsed.asDouble() == value);
+  }
+  CHECK(Json::BufferWriter().write(Json::Value(1.0)) == "1.0");
+}
+
+int main() {
+  testSparseArrays();
+  testReals();
+  testScalarsAndNesting();
+  if (failures)
+    std::fprintf(stderr, "%d check(s) failed\n", failures);
+  return failures ? 1 : 0;
+}
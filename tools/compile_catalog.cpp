@@ -0,0 +1,24 @@
+// 将 JSON 语言文件编译为二进制语言包
+// g++ -std=c++17 -I. -Iinclude tools/compile_catalog.cpp chh.cpp hti.*.cpp include/json/*.cpp -pthread -o compile_catalog
+// ./compile_catalog zh_cn.json zh_cn.htil
+// 生成的文件用 Application::registerLanguageFromCatalog 登记，或者嵌入程序后用 loadLanguageFromResource 加载。
+#include "hti.hpp"
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::fprintf(stderr, "usage: %s <input.json> <output.htil>\n", argv[0]);
+        return 2;
+    }
+    try {
+        const auto content = chh::readFile(argv[1]);
+        const std::string catalog = hti::i18n::Language::compile(std::string_view(content.data(), content.size()));
+        std::ofstream output(argv[2], std::ios::binary);
+        output.write(catalog.data(), catalog.size());
+        if (!output) throw std::runtime_error("Unable to write file: " + std::string(argv[2]) + ".");
+    }
+    catch (const std::exception& e) {
+        std::fprintf(stderr, "%s: %s\n", argv[1], e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,29 @@
+#!/bin/sh
+# 把文件嵌入一个目标文件，链接后用 CHH_RESOURCE 登记（仅 Linux）
+# 用法：tools/embed_resources.sh <output.o> <file>...
+# 符号名只取文件名，非字母数字换成下划线：lang/zh.json 定义 _binary_zh_json_start 与 _binary_zh_json_end，
+# 源文件中写 CHH_RESOURCE("zh", zh_json)。数据放在只读段，末尾不补零。
+# 可以用 LD 和 OBJCOPY 环境变量指定交叉编译的工具。
+set -eu
+
+if [ $# -lt 2 ]; then
+	echo "usage: $0 <output.o> <file>..." >&2
+	exit 2
+fi
+
+LD=${LD:-ld}
+OBJCOPY=${OBJCOPY:-objcopy}
+output=$1
+shift
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+i=0
+for file in "$@"; do
+	i=$((i + 1))
+	# 在文件所在的目录里运行 ld，符号名就不会带上路径。
+	(cd "$(dirname "$file")" && "$LD" -r -b binary -z noexecstack -o "$work/$i.o" "$(basename "$file")")
+	"$OBJCOPY" --rename-section .data=.rodata,alloc,load,readonly,data,contents "$work/$i.o"
+	echo "$file: CHH_RESOURCE(..., $(basename "$file" | sed 's/[^A-Za-z0-9_]/_/g'))"
+done
+"$LD" -r -z noexecstack -o "$output" "$work"/*.o